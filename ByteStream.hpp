@@ -0,0 +1,136 @@
+#pragma once
+
+#include "main.hpp"
+
+#include <cstring>
+#include <string_view>
+
+// ==============================================
+// BYTE STREAMS
+// ==============================================
+//
+// Little-endian append/read helpers for the editor's binary formats (undo
+// commands, undo log, binary level data). Integers are LEB128 varints,
+// signed ones zigzag-encoded first, so small values and small deltas take
+// one byte. Floats are stored raw.
+//
+// ByteReader never reads past its end: a short or corrupt buffer sets
+// failed() and every later read returns 0.
+
+class ByteWriter {
+public:
+    explicit ByteWriter(std::vector<uint8_t>& out) : m_out(out) {}
+
+    void putByte(uint8_t value) { m_out.push_back(value); }
+
+    void putVarint(uint64_t value) {
+        while (value >= 0x80) {
+            m_out.push_back(static_cast<uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        m_out.push_back(static_cast<uint8_t>(value));
+    }
+
+    void putSigned(int64_t value) {
+        putVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    void putFloat(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        putFixed32(bits);
+    }
+
+    void putFixed32(uint32_t value) {
+        for (int i = 0; i < 4; ++i) m_out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+
+    void putBytes(const void* data, size_t size) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        m_out.insert(m_out.end(), bytes, bytes + size);
+    }
+
+    // varint length + bytes
+    void putString(std::string_view text) {
+        putVarint(text.size());
+        putBytes(text.data(), text.size());
+    }
+
+    size_t size() const { return m_out.size(); }
+
+private:
+    std::vector<uint8_t>& m_out;
+};
+
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size) : m_cursor(data), m_end(data + size) {}
+
+    bool failed() const { return m_failed; }
+    bool atEnd() const { return m_cursor == m_end; }
+    size_t remaining() const { return static_cast<size_t>(m_end - m_cursor); }
+    const uint8_t* position() const { return m_cursor; }
+
+    uint8_t getByte() {
+        if (m_cursor == m_end) return fail();
+        return *m_cursor++;
+    }
+
+    uint64_t getVarint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (m_cursor == m_end) return fail();
+            uint8_t byte = *m_cursor++;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        return fail();  // more than 10 bytes
+    }
+
+    int64_t getSigned() {
+        uint64_t value = getVarint();
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    float getFloat() {
+        uint32_t bits = getFixed32();
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    uint32_t getFixed32() {
+        if (remaining() < 4) return fail();
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(m_cursor[i]) << (i * 8);
+        m_cursor += 4;
+        return value;
+    }
+
+    // Points into the buffer; empty on failure.
+    std::string_view getBytes(size_t size) {
+        if (remaining() < size) {
+            fail();
+            return {};
+        }
+        std::string_view bytes(reinterpret_cast<const char*>(m_cursor), size);
+        m_cursor += size;
+        return bytes;
+    }
+
+    std::string_view getString() {
+        uint64_t size = getVarint();
+        return m_failed ? std::string_view() : getBytes(static_cast<size_t>(size));
+    }
+
+private:
+    uint8_t fail() {
+        m_failed = true;
+        m_cursor = m_end;
+        return 0;
+    }
+
+    const uint8_t* m_cursor;
+    const uint8_t* m_end;
+    bool m_failed = false;
+};
@@ -0,0 +1,297 @@
+// CollisionBroadPhase.cpp
+#include "CollisionBroadPhase.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+BroadPhaseRect BroadPhaseRect::swept(const BroadPhaseRect& from, const BroadPhaseRect& to) {
+    return {std::min(from.minX, to.minX), std::min(from.minY, to.minY),
+            std::max(from.maxX, to.maxX), std::max(from.maxY, to.maxY)};
+}
+
+// ==============================================
+// BUILD (level load)
+// ==============================================
+
+// Section index of a coordinate. Clamped well inside int range so stray
+// coordinates (huge, infinite or NaN) still land in some cell.
+int CollisionBroadPhase::sectionFor(float value, float sectionSize) {
+    constexpr double kLimit = 1 << 30;
+    double section = std::floor(static_cast<double>(value) / sectionSize);
+    if (!(section > -kLimit)) return -(1 << 30);   // also NaN
+    if (section > kLimit) return 1 << 30;
+    return static_cast<int>(section);
+}
+
+// Flipping the sign bits keeps signed (column, row) order in the unsigned key.
+uint64_t CollisionBroadPhase::cellKey(int column, int row) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(column) ^ 0x80000000u) << 32) |
+           (static_cast<uint32_t>(row) ^ 0x80000000u);
+}
+
+// Cells an object's bounds cover; 0 or less for bounds too large to count.
+int64_t CollisionBroadPhase::cellCount(const BroadPhaseRect& rect) {
+    int c0 = sectionFor(rect.minX, kSectionWidth), c1 = sectionFor(rect.maxX, kSectionWidth);
+    int r0 = sectionFor(rect.minY, kSectionHeight), r1 = sectionFor(rect.maxY, kSectionHeight);
+    return (int64_t(c1) - c0 + 1) * (int64_t(r1) - r0 + 1);
+}
+
+void CollisionBroadPhase::build(const std::vector<BroadPhaseRect>& bounds) {
+    clear();
+    m_bounds = bounds;
+    m_placement.assign(bounds.size(), kStatic);
+    m_lastMoved.assign(bounds.size(), 0);
+    m_queryContext.stamps.assign(bounds.size(), 0);
+
+    // ===== PASS 1: (CELL, OBJECT) ENTRIES =====
+    std::vector<std::pair<uint64_t, uint32_t>> entries;
+    entries.reserve(bounds.size() * 2);
+    for (uint32_t index = 0; index < bounds.size(); ++index) {
+        const BroadPhaseRect& rect = bounds[index];
+        int64_t cells = cellCount(rect);
+        if (cells > kMaxCellsPerObject || cells <= 0) {
+            m_large.push_back(index);
+            continue;
+        }
+
+        int c0 = sectionFor(rect.minX, kSectionWidth), c1 = sectionFor(rect.maxX, kSectionWidth);
+        int r0 = sectionFor(rect.minY, kSectionHeight), r1 = sectionFor(rect.maxY, kSectionHeight);
+
+        for (int c = c0; c <= c1; ++c) {
+            for (int r = r0; r <= r1; ++r) {
+                entries.emplace_back(cellKey(c, r), index);
+            }
+        }
+        if (m_maxColumn < m_minColumn) {
+            m_minColumn = c0; m_maxColumn = c1;
+            m_minRow = r0;    m_maxRow = r1;
+        } else {
+            m_minColumn = std::min(m_minColumn, c0); m_maxColumn = std::max(m_maxColumn, c1);
+            m_minRow = std::min(m_minRow, r0);       m_maxRow = std::max(m_maxRow, r1);
+        }
+    }
+
+    // ===== PASS 2: SORT BY CELL (objects in index order within each cell) =====
+    std::sort(entries.begin(), entries.end());
+
+    // ===== PASS 3: COMPACT INTO CELLS =====
+    m_cellItems.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (i == 0 || entries[i].first != entries[i - 1].first) {
+            m_cellKeys.push_back(entries[i].first);
+            m_cellStart.push_back(static_cast<uint32_t>(i));
+        }
+        m_cellItems[i] = entries[i].second;
+    }
+    m_cellStart.push_back(static_cast<uint32_t>(entries.size()));
+}
+
+void CollisionBroadPhase::clear() {
+    m_bounds.clear();
+    m_placement.clear();
+    m_lastMoved.clear();
+    m_dynamic.clear();
+    m_settled.clear();
+    m_settledCells.clear();
+    m_large.clear();
+    m_frame = 0;
+    m_cellKeys.clear();
+    m_cellStart.clear();
+    m_cellItems.clear();
+    m_queryContext.stamps.clear();
+    m_queryContext.generation = 0;
+    m_minColumn = m_minRow = 0;
+    m_maxColumn = m_maxRow = -1;
+}
+
+// ==============================================
+// MOVING OBJECTS
+// ==============================================
+
+void CollisionBroadPhase::markDynamic(uint32_t index) {
+    if (index >= m_bounds.size()) {
+        return;
+    }
+    m_lastMoved[index] = m_frame;
+    if (m_placement[index] == kDynamic) {
+        return;
+    }
+    // The object stays in its old grid cells (load-time or settled);
+    // gather() skips entries whose placement doesn't match.
+    m_placement[index] = kDynamic;
+    m_dynamic.push_back(index);
+}
+
+void CollisionBroadPhase::updateBounds(uint32_t index, const BroadPhaseRect& bounds) {
+    if (index >= m_bounds.size()) {
+        return;
+    }
+    markDynamic(index);
+    m_bounds[index] = bounds;
+}
+
+void CollisionBroadPhase::advanceFrame() {
+    ++m_frame;
+
+    bool settled = false;
+    size_t kept = 0;
+    for (uint32_t index : m_dynamic) {
+        int64_t cells = cellCount(m_bounds[index]);
+        if (m_frame - m_lastMoved[index] >= kSettleFrames && cells > 0 && cells <= kMaxCellsPerObject) {
+            m_placement[index] = kSettled;
+            m_settled.push_back(index);
+            settled = true;
+        } else {
+            m_dynamic[kept++] = index;
+        }
+    }
+    m_dynamic.resize(kept);
+
+    if (settled) {
+        rebuildSettled();
+    }
+}
+
+// Only objects that have ever moved are in here, so a rebuild sorts a few
+// entries per moved object, not the level.
+void CollisionBroadPhase::rebuildSettled() {
+    std::sort(m_settled.begin(), m_settled.end());
+    m_settled.erase(std::unique(m_settled.begin(), m_settled.end()), m_settled.end());
+
+    m_settledCells.clear();
+    size_t kept = 0;
+    for (uint32_t index : m_settled) {
+        if (m_placement[index] != kSettled) {
+            continue;   // moving again
+        }
+        m_settled[kept++] = index;
+
+        const BroadPhaseRect& rect = m_bounds[index];
+        int c0 = sectionFor(rect.minX, kSectionWidth), c1 = sectionFor(rect.maxX, kSectionWidth);
+        int r0 = sectionFor(rect.minY, kSectionHeight), r1 = sectionFor(rect.maxY, kSectionHeight);
+        for (int c = c0; c <= c1; ++c) {
+            for (int r = r0; r <= r1; ++r) {
+                m_settledCells.emplace_back(cellKey(c, r), index);
+            }
+        }
+    }
+    m_settled.resize(kept);
+    std::sort(m_settledCells.begin(), m_settledCells.end());
+}
+
+// ==============================================
+// QUERIES
+// ==============================================
+
+void CollisionBroadPhase::gather(const BroadPhaseRect& area, std::vector<uint32_t>& out,
+                                 BroadPhaseQueryContext& context) const {
+    auto visitCell = [&](size_t cell) {
+        for (uint32_t item = m_cellStart[cell]; item < m_cellStart[cell + 1]; ++item) {
+            uint32_t index = m_cellItems[item];
+            if (context.stamps[index] == context.generation || m_placement[index] != kStatic) {
+                continue;
+            }
+            context.stamps[index] = context.generation;
+            if (m_bounds[index].intersects(area)) {
+                out.push_back(index);
+            }
+        }
+    };
+
+    if (!m_cellKeys.empty()) {
+        int c0 = std::max(sectionFor(area.minX, kSectionWidth), m_minColumn);
+        int c1 = std::min(sectionFor(area.maxX, kSectionWidth), m_maxColumn);
+        int r0 = std::max(sectionFor(area.minY, kSectionHeight), m_minRow);
+        int r1 = std::min(sectionFor(area.maxY, kSectionHeight), m_maxRow);
+
+        if (c0 <= c1 && r0 <= r1) {
+            if (int64_t(c1) - c0 + 1 > static_cast<int64_t>(m_cellKeys.size())) {
+                // Wider than the number of occupied cells: walk those instead.
+                uint64_t first = cellKey(c0, r0), last = cellKey(c1, r1);
+                uint32_t firstRow = static_cast<uint32_t>(first), lastRow = static_cast<uint32_t>(last);
+                for (size_t cell = 0; cell < m_cellKeys.size(); ++cell) {
+                    uint64_t key = m_cellKeys[cell];
+                    uint32_t row = static_cast<uint32_t>(key);
+                    if (key >= first && key <= last && row >= firstRow && row <= lastRow) {
+                        visitCell(cell);
+                    }
+                }
+            } else {
+                for (int c = c0; c <= c1; ++c) {
+                    // Rows of one column are adjacent keys, so this is one run.
+                    uint64_t last = cellKey(c, r1);
+                    auto it = std::lower_bound(m_cellKeys.begin(), m_cellKeys.end(), cellKey(c, r0));
+                    for (; it != m_cellKeys.end() && *it <= last; ++it) {
+                        visitCell(static_cast<size_t>(it - m_cellKeys.begin()));
+                    }
+                }
+            }
+        }
+    }
+
+    if (!m_settledCells.empty()) {
+        int c0 = sectionFor(area.minX, kSectionWidth), c1 = sectionFor(area.maxX, kSectionWidth);
+        int r0 = sectionFor(area.minY, kSectionHeight), r1 = sectionFor(area.maxY, kSectionHeight);
+        auto visit = [&](uint32_t index) {
+            if (context.stamps[index] == context.generation || m_placement[index] != kSettled) {
+                return;
+            }
+            context.stamps[index] = context.generation;
+            if (m_bounds[index].intersects(area)) {
+                out.push_back(index);
+            }
+        };
+
+        if (int64_t(c1) - c0 + 1 > static_cast<int64_t>(m_settledCells.size())) {
+            uint64_t first = cellKey(c0, r0), last = cellKey(c1, r1);
+            uint32_t firstRow = static_cast<uint32_t>(first), lastRow = static_cast<uint32_t>(last);
+            for (const auto& entry : m_settledCells) {
+                uint32_t row = static_cast<uint32_t>(entry.first);
+                if (entry.first >= first && entry.first <= last && row >= firstRow && row <= lastRow) {
+                    visit(entry.second);
+                }
+            }
+        } else {
+            for (int c = c0; c <= c1; ++c) {
+                uint64_t last = cellKey(c, r1);
+                auto it = std::lower_bound(m_settledCells.begin(), m_settledCells.end(),
+                                           std::make_pair(cellKey(c, r0), uint32_t(0)));
+                for (; it != m_settledCells.end() && it->first <= last; ++it) {
+                    visit(it->second);
+                }
+            }
+        }
+    }
+
+    for (uint32_t index : m_large) {
+        if (m_placement[index] == kStatic && m_bounds[index].intersects(area)) {
+            out.push_back(index);
+        }
+    }
+    for (uint32_t index : m_dynamic) {
+        if (m_bounds[index].intersects(area)) {
+            out.push_back(index);
+        }
+    }
+}
+
+void CollisionBroadPhase::query(const BroadPhaseRect& area, std::vector<uint32_t>& out) const {
+    query(area, out, m_queryContext);
+}
+
+void CollisionBroadPhase::query(const BroadPhaseRect& area, std::vector<uint32_t>& out,
+                                BroadPhaseQueryContext& context) const {
+    out.clear();
+    if (context.stamps.size() != m_bounds.size()) {
+        // First query with this context since the level was (re)built
+        context.stamps.assign(m_bounds.size(), 0);
+        context.generation = 0;
+    }
+    if (++context.generation == 0) {
+        // Stamp wrap-around: reset so stale stamps can't match.
+        std::fill(context.stamps.begin(), context.stamps.end(), 0);
+        context.generation = 1;
+    }
+    gather(area, out, context);
+    std::sort(out.begin(), out.end());
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "main.hpp"
+
+// ==============================================
+// COLLISION BROAD-PHASE
+// ==============================================
+//
+// Section grid over the level's collidable objects, built once at load time.
+// Objects are bucketed by X column (GD's 100-unit sections) and Y row. Only
+// occupied cells are stored, CSR-style: cell keys sorted by (column, row),
+// one flat index array and per-cell offsets. Rows of a column are adjacent
+// keys, so a query does one binary search per column and walks a contiguous
+// run. Memory follows the number of objects, not the level's bounding box,
+// so an object placed far outside the level costs one cell.
+//
+// Objects covering more than kMaxCellsPerObject cells (huge scaled blocks)
+// are kept in a list every query scans instead of being copied into each
+// cell.
+//
+// Objects moved by triggers are taken out of the grid with markDynamic() and
+// kept in a short list that every query scans; the static grid never has to
+// be rebuilt mid-level. Once a moved object has kept still for
+// kSettleFrames frames, advanceFrame() re-buckets it into a second, small
+// grid of settled objects (same sorted-key layout, rebuilt only when
+// something settles), so a group that moved once stops costing every query.
+//
+// Queries take the player's swept AABB (union of last and current tick) and
+// return object indices, each at most once, in ascending index order.
+//
+// The grid itself is read-only during queries. The "already reported" stamps
+// live in a BroadPhaseQueryContext; the overloads without one share an
+// internal context, so only the context overload may be called from several
+// threads at once (one context per thread).
+
+struct BroadPhaseRect {
+    float minX, minY, maxX, maxY;
+
+    static BroadPhaseRect fromOriginSize(float x, float y, float w, float h) {
+        return {x, y, x + w, y + h};
+    }
+
+    // Union of the player's box at the previous and current tick.
+    static BroadPhaseRect swept(const BroadPhaseRect& from, const BroadPhaseRect& to);
+
+    bool intersects(const BroadPhaseRect& other) const {
+        return minX <= other.maxX && maxX >= other.minX &&
+               minY <= other.maxY && maxY >= other.minY;
+    }
+};
+
+// Player-vs-solid rule shared by GJBaseGameLayer and HeadlessLevelSimulator:
+// a player whose bottom has sunk at most kLandingTolerance into an object's
+// top lands on it; any other overlap is a side or bottom hit.
+constexpr float kLandingTolerance = 9.0f;
+
+inline bool landsOnTop(const BroadPhaseRect& player, const BroadPhaseRect& object) {
+    return player.minY >= object.maxY - kLandingTolerance;
+}
+
+struct BroadPhaseQueryContext {
+    std::vector<uint32_t> stamps;
+    uint32_t generation = 0;
+};
+
+class CollisionBroadPhase {
+public:
+    static constexpr float kSectionWidth = 100.0f;
+    static constexpr float kSectionHeight = 100.0f;
+    static constexpr int   kMaxCellsPerObject = 64;
+    static constexpr uint32_t kSettleFrames = 30;
+
+    // bounds[i] is the AABB of object i; indices returned by queries refer
+    // back into the caller's object list.
+    void build(const std::vector<BroadPhaseRect>& bounds);
+    void clear();
+
+    // Moves object index out of the static grid (e.g. it joined a move group).
+    void markDynamic(uint32_t index);
+    void updateBounds(uint32_t index, const BroadPhaseRect& bounds);
+
+    // Once per frame, outside queries (GJBaseGameLayer::updateLevel after the
+    // players' join point): settles objects that stopped moving.
+    void advanceFrame();
+
+    size_t dynamicCount() const { return m_dynamic.size(); }
+
+    void query(const BroadPhaseRect& area, std::vector<uint32_t>& out) const;
+    void query(const BroadPhaseRect& area, std::vector<uint32_t>& out,
+               BroadPhaseQueryContext& context) const;
+
+    size_t objectCount() const { return m_bounds.size(); }
+    const BroadPhaseRect& bounds(uint32_t index) const { return m_bounds[index]; }
+
+private:
+    static int sectionFor(float value, float sectionSize);
+    static uint64_t cellKey(int column, int row);
+    static int64_t cellCount(const BroadPhaseRect& rect);
+    void rebuildSettled();
+    void gather(const BroadPhaseRect& area, std::vector<uint32_t>& out,
+                BroadPhaseQueryContext& context) const;
+
+    // Where an object is found: the load-time grid (or m_large), the dynamic
+    // list, or the settled grid. Entries left behind in the other structures
+    // are skipped by this check.
+    enum Placement : uint8_t { kStatic = 0, kDynamic = 1, kSettled = 2 };
+
+    std::vector<BroadPhaseRect> m_bounds;
+    std::vector<uint8_t>  m_placement;
+    std::vector<uint32_t> m_lastMoved;   // frame of the last updateBounds
+    std::vector<uint32_t> m_dynamic;
+    std::vector<uint32_t> m_settled;
+    std::vector<uint32_t> m_large;       // spans more than kMaxCellsPerObject cells
+    uint32_t m_frame = 0;
+
+    // Settled objects as sorted (cell key, index) pairs
+    std::vector<std::pair<uint64_t, uint32_t>> m_settledCells;
+
+    // Sparse CSR grid: cell m_cellKeys[k] holds
+    // m_cellItems[m_cellStart[k] .. m_cellStart[k + 1])
+    std::vector<uint64_t> m_cellKeys;
+    std::vector<uint32_t> m_cellStart;
+    std::vector<uint32_t> m_cellItems;
+    int m_minColumn = 0, m_maxColumn = -1;
+    int m_minRow = 0, m_maxRow = -1;
+
+    // Per-object stamp so objects spanning several cells are reported once.
+    mutable BroadPhaseQueryContext m_queryContext;
+};
@@ -0,0 +1,232 @@
+// EditorAutoSave.cpp
+#include "EditorAutoSave.hpp"
+#include "MappedFile.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include <unistd.h>
+#include <zlib.h>
+
+static int32_t chunkKeyOf(int32_t uniqueID) {
+    // floor division, so negative IDs get their own chunks too
+    return uniqueID >= 0 ? uniqueID / EditorAutoSave::kChunkIDs
+                         : -1 - (-1 - uniqueID) / EditorAutoSave::kChunkIDs;
+}
+
+static bool byUniqueID(const EditorObjectRecord& record, int32_t uniqueID) {
+    return record.uniqueID < uniqueID;
+}
+
+// ==============================================
+// CHANGE TRACKING
+// ==============================================
+
+void AutoSaveChanges::mark(int uniqueID, State state) {
+    if (uniqueID < 0) {
+        return;
+    }
+    if (static_cast<size_t>(uniqueID) >= m_state.size()) {
+        m_state.resize(static_cast<size_t>(uniqueID) + 1, kClean);
+    }
+    if (m_state[uniqueID] == kClean) {
+        m_pending.push_back(uniqueID);
+    }
+    m_state[uniqueID] = state;
+}
+
+void AutoSaveChanges::markReset() {
+    for (int uniqueID : m_pending) m_state[uniqueID] = kClean;
+    m_pending.clear();
+    m_reset = true;
+}
+
+void AutoSaveChanges::take(std::vector<int>& ids, bool& reset) {
+    ids.clear();
+    ids.swap(m_pending);
+    reset = m_reset;
+    m_reset = false;
+}
+
+AutoSaveChanges::State AutoSaveChanges::consume(int uniqueID) {
+    if (uniqueID < 0 || static_cast<size_t>(uniqueID) >= m_state.size()) {
+        return kClean;
+    }
+    auto state = static_cast<State>(m_state[uniqueID]);
+    m_state[uniqueID] = kClean;
+    return state;
+}
+
+// ==============================================
+// APPLYING SNAPSHOTS
+// ==============================================
+
+void EditorAutoSave::apply(const AutoSaveBatch& batch) {
+    if (batch.reset) {
+        m_chunks.clear();
+    }
+    if (batch.complete) {
+        m_levelHeader = batch.levelHeader;
+    }
+
+    for (int uniqueID : batch.removed) {
+        auto chunk = m_chunks.find(chunkKeyOf(uniqueID));
+        if (chunk == m_chunks.end()) {
+            continue;
+        }
+        std::vector<EditorObjectRecord>& objects = chunk->second.objects;
+        auto it = std::lower_bound(objects.begin(), objects.end(), uniqueID, byUniqueID);
+        if (it != objects.end() && it->uniqueID == uniqueID) {
+            objects.erase(it);
+            chunk->second.dirty = true;
+        }
+    }
+
+    for (const EditorObjectRecord& record : batch.changed) {
+        Chunk& chunk = m_chunks[chunkKeyOf(record.uniqueID)];
+        auto it = std::lower_bound(chunk.objects.begin(), chunk.objects.end(), record.uniqueID, byUniqueID);
+        if (it != chunk.objects.end() && it->uniqueID == record.uniqueID) {
+            *it = record;
+        } else {
+            chunk.objects.insert(it, record);
+        }
+        chunk.dirty = true;
+    }
+}
+
+size_t EditorAutoSave::objectCount() const {
+    size_t count = 0;
+    for (const auto& chunk : m_chunks) count += chunk.second.objects.size();
+    return count;
+}
+
+// ==============================================
+// WRITING
+// ==============================================
+
+// Fastest zlib level: an autosave is rewritten often and read once, and the
+// default level costs about four times the CPU for ~20% less disk.
+bool EditorAutoSave::encode(Chunk& chunk) {
+    m_scratch.clear();
+    for (size_t i = 0; i < chunk.objects.size(); ++i) {
+        if (i > 0) m_scratch.push_back(';');
+        appendObjectString(chunk.objects[i], m_scratch);
+    }
+
+    uLongf compressedSize = compressBound(static_cast<uLong>(m_scratch.size()));
+    chunk.compressed.resize(compressedSize);
+    int result = compress2(chunk.compressed.data(), &compressedSize,
+                           reinterpret_cast<const Bytef*>(m_scratch.data()),
+                           static_cast<uLong>(m_scratch.size()), Z_BEST_SPEED);
+    if (result != Z_OK) {
+        return false;
+    }
+    chunk.compressed.resize(compressedSize);
+    chunk.compressed.shrink_to_fit();
+    chunk.rawSize = static_cast<uint32_t>(m_scratch.size());
+    chunk.dirty = false;
+    return true;
+}
+
+bool EditorAutoSave::write(const std::string& path) {
+    for (auto it = m_chunks.begin(); it != m_chunks.end();) {
+        if (it->second.objects.empty()) {
+            it = m_chunks.erase(it);
+            continue;
+        }
+        if (it->second.dirty && !encode(it->second)) {
+            return false;
+        }
+        ++it;
+    }
+
+    uint32_t count = static_cast<uint32_t>(m_chunks.size());
+    std::vector<AutoSaveChunk> table;
+    table.reserve(count);
+    uint64_t dataCursor = sizeof(AutoSaveHeader) + uint64_t(count) * sizeof(AutoSaveChunk) + m_levelHeader.size();
+    uint32_t objectTotal = 0;
+    for (const auto& [key, chunk] : m_chunks) {
+        AutoSaveChunk entry;
+        entry.chunkKey = key;
+        entry.objectCount = static_cast<uint32_t>(chunk.objects.size());
+        entry.rawSize = chunk.rawSize;
+        entry.compressedSize = static_cast<uint32_t>(chunk.compressed.size());
+        entry.dataOffset = dataCursor;
+        dataCursor += entry.compressedSize;
+        objectTotal += entry.objectCount;
+        table.push_back(entry);
+    }
+
+    AutoSaveHeader header;
+    std::memcpy(header.magic, "GDAS", 4);
+    header.version = kVersion;
+    header.reserved = 0;
+    header.chunkCount = count;
+    header.objectCount = objectTotal;
+    header.levelHeaderSize = static_cast<uint32_t>(m_levelHeader.size());
+    header.fileSize = dataCursor;
+
+    std::string tempPath = path + ".tmp";
+    FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && (count == 0 || std::fwrite(table.data(), sizeof(AutoSaveChunk), count, file) == count);
+    ok = ok && std::fwrite(m_levelHeader.data(), 1, m_levelHeader.size(), file) == m_levelHeader.size();
+    for (auto it = m_chunks.begin(); ok && it != m_chunks.end(); ++it) {
+        const std::vector<uint8_t>& data = it->second.compressed;
+        ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    }
+    // The autosave is what survives a crash, so it must be on disk before it
+    // replaces the previous one.
+    ok = ok && std::fflush(file) == 0 && ::fsync(fileno(file)) == 0;
+    ok = (std::fclose(file) == 0) && ok;
+
+    if (!ok || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+// ==============================================
+// RESTORING
+// ==============================================
+
+bool EditorAutoSave::read(const std::string& path, std::string& levelString) {
+    MappedFile file;
+    if (!file.open(path) || file.size() < sizeof(AutoSaveHeader)) {
+        return false;
+    }
+
+    AutoSaveHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    uint64_t tableEnd = sizeof(AutoSaveHeader) + uint64_t(header.chunkCount) * sizeof(AutoSaveChunk);
+    if (std::memcmp(header.magic, "GDAS", 4) != 0 || header.version != kVersion ||
+        header.fileSize != file.size() || tableEnd + header.levelHeaderSize > file.size()) {
+        return false;
+    }
+
+    levelString.assign(reinterpret_cast<const char*>(file.data()) + tableEnd, header.levelHeaderSize);
+    for (uint32_t i = 0; i < header.chunkCount; ++i) {
+        AutoSaveChunk chunk;
+        std::memcpy(&chunk, file.data() + sizeof(AutoSaveHeader) + size_t(i) * sizeof(AutoSaveChunk), sizeof(chunk));
+        if (chunk.dataOffset > file.size() || chunk.compressedSize > file.size() - chunk.dataOffset) {
+            return false;
+        }
+
+        if (!levelString.empty()) levelString.push_back(';');
+        size_t start = levelString.size();
+        levelString.resize(start + chunk.rawSize);
+        uLongf rawSize = chunk.rawSize;
+        int result = uncompress(reinterpret_cast<Bytef*>(&levelString[start]), &rawSize,
+                                file.data() + chunk.dataOffset, chunk.compressedSize);
+        if (result != Z_OK || rawSize != chunk.rawSize) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "main.hpp"
+#include "EditorObjectRecord.hpp"
+
+// ==============================================
+// INCREMENTAL EDITOR AUTOSAVE
+// ==============================================
+//
+// Autosave without serializing the whole level under the editor lock:
+//
+//   main thread    AutoSaveChanges collects the unique IDs changed or
+//                  removed since the last pass. A pass copies only those
+//                  objects into EditorObjectRecords, a bounded number per
+//                  frame, and queues them as AutoSaveBatches.
+//   autosave thread  EditorAutoSave keeps the last saved records in chunks
+//                  of kChunkIDs consecutive unique IDs, each with its
+//                  compressed object string cached. Applying a batch marks
+//                  the chunks it touches; write() re-encodes and recompresses
+//                  just those, then writes every chunk to a temp file that
+//                  is renamed over the autosave, so a crash mid-write leaves
+//                  the previous autosave intact.
+//
+// Objects placed together have neighbouring unique IDs, so an edit usually
+// touches a handful of chunks whatever the size of the level.
+//
+// Layout (little-endian):
+//   AutoSaveHeader
+//   AutoSaveChunk[chunkCount]     sorted by first unique ID
+//   level header                  levelHeaderSize bytes ("kS38,..."), as is
+//   chunk data                    zlib-compressed object strings, ';'-joined
+
+#pragma pack(push, 1)
+struct AutoSaveHeader {
+    char     magic[4];        // "GDAS"
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t chunkCount;
+    uint32_t objectCount;
+    uint32_t levelHeaderSize;
+    uint64_t fileSize;        // truncated files are rejected
+};
+
+struct AutoSaveChunk {
+    int32_t  chunkKey;        // unique ID / kChunkIDs
+    uint32_t objectCount;
+    uint32_t rawSize;
+    uint32_t compressedSize;
+    uint64_t dataOffset;
+};
+#pragma pack(pop)
+
+// Main thread: what changed since the last snapshot. Unique IDs are small
+// sequential counters, so the state is a flat array indexed by ID plus the
+// list of IDs whose state is set; starting a pass just takes the list.
+class AutoSaveChanges {
+public:
+    enum State : uint8_t { kClean = 0, kChanged, kRemoved };
+
+    void markChanged(int uniqueID) { mark(uniqueID, kChanged); }
+    void markRemoved(int uniqueID) { mark(uniqueID, kRemoved); }
+    // The level was rebuilt; the next save starts from scratch.
+    void markReset();
+
+    bool empty() const { return m_pending.empty() && !m_reset; }
+
+    // Starts a pass with the IDs marked so far. Their state stays set until
+    // consume() reads it, so an edit made before the pass reaches an object
+    // is still picked up by that pass; edits after it go to the next one.
+    void take(std::vector<int>& ids, bool& reset);
+    State consume(int uniqueID);
+
+private:
+    void mark(int uniqueID, State state);
+
+    std::vector<uint8_t> m_state;   // State by unique ID
+    std::vector<int> m_pending;     // IDs with a state set, not yet taken
+    bool m_reset = false;
+};
+
+// One slice of a pass, handed from the main thread to the autosave thread.
+struct AutoSaveBatch {
+    std::vector<EditorObjectRecord> changed;
+    std::vector<int> removed;
+    bool reset = false;       // drop everything saved before applying
+    bool complete = false;    // last slice of the pass: write the file
+    std::string levelHeader;  // set on the complete slice
+};
+
+// Autosave thread only.
+class EditorAutoSave {
+public:
+    static constexpr uint16_t kVersion = 2;
+    static constexpr int32_t kChunkIDs = 512;
+
+    void apply(const AutoSaveBatch& batch);
+    // Recompresses the chunks touched since the last write and writes path.
+    bool write(const std::string& path);
+    void clear() {
+        m_chunks.clear();
+        m_levelHeader.clear();
+    }
+
+    size_t objectCount() const;
+
+    // Main thread, on restore: the autosaved level as a level string, the
+    // level header in front of the objects, as deserializeLevel takes it.
+    static bool read(const std::string& path, std::string& levelString);
+
+private:
+    struct Chunk {
+        std::vector<EditorObjectRecord> objects;   // sorted by unique ID
+        std::vector<uint8_t> compressed;
+        uint32_t rawSize = 0;
+        bool dirty = true;
+    };
+
+    bool encode(Chunk& chunk);
+
+    std::map<int32_t, Chunk> m_chunks;
+    std::string m_levelHeader;
+    std::string m_scratch;
+};
@@ -0,0 +1,151 @@
+// EditorObjectRecord.cpp
+#include "EditorObjectRecord.hpp"
+
+#include <charconv>
+
+// to_chars gives the shortest text that parses back to the same float, so
+// saving and loading never drifts positions.
+static void appendNumber(std::string& out, float value) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+static void appendNumber(std::string& out, int32_t value) {
+    char buffer[16];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+template <typename T>
+static void appendKey(std::string& out, int key, T value) {
+    out.push_back(',');
+    appendNumber(out, key);
+    out.push_back(',');
+    appendNumber(out, value);
+}
+
+void appendObjectString(const EditorObjectRecord& record, std::string& out) {
+    out += "1,";
+    appendNumber(out, record.objectID);
+    appendKey(out, 2, record.x);
+    appendKey(out, 3, record.y);
+    if (record.rotation != 0.0f) appendKey(out, 6, record.rotation);
+    if (record.mainColor != 0) appendKey(out, 21, int32_t(record.mainColor));
+    if (record.detailColor != 0) appendKey(out, 22, int32_t(record.detailColor));
+    if (record.zOrder != 0) appendKey(out, 25, record.zOrder);
+    if (record.groupCount > 0) {
+        out += ",57,";
+        for (int i = 0; i < record.groupCount && i < EditorObjectRecord::kMaxGroups; ++i) {
+            if (i > 0) out.push_back('.');
+            appendNumber(out, int32_t(record.groups[i]));
+        }
+    }
+    if (record.scaleX != 1.0f) appendKey(out, 128, record.scaleX);
+    if (record.scaleY != 1.0f) appendKey(out, 129, record.scaleY);
+    if (record.hidden) out += ",135,1";
+    out += record.extra;
+}
+
+void appendObjectStrings(const std::vector<EditorObjectRecord>& records, std::string& out) {
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (i > 0) out.push_back(';');
+        appendObjectString(records[i], out);
+    }
+}
+
+// ==============================================
+// PARSING
+// ==============================================
+
+template <typename T>
+static bool parseNumber(std::string_view text, T& value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+static bool parseGroups(std::string_view text, EditorObjectRecord& record) {
+    record.groupCount = 0;
+    while (!text.empty()) {
+        size_t dot = text.find('.');
+        int32_t group;
+        if (!parseNumber(text.substr(0, dot), group)) {
+            return false;
+        }
+        if (record.groupCount < EditorObjectRecord::kMaxGroups) {
+            record.groups[record.groupCount++] = static_cast<int16_t>(group);
+        }
+        text = dot == std::string_view::npos ? std::string_view() : text.substr(dot + 1);
+    }
+    return true;
+}
+
+bool parseObjectString(std::string_view text, EditorObjectRecord& record) {
+    record = EditorObjectRecord();
+    bool hasObjectID = false;
+
+    while (!text.empty()) {
+        size_t keyEnd = text.find(',');
+        if (keyEnd == std::string_view::npos) {
+            return false;  // key without a value
+        }
+        std::string_view key = text.substr(0, keyEnd);
+        size_t valueEnd = text.find(',', keyEnd + 1);
+        std::string_view value = text.substr(keyEnd + 1, valueEnd == std::string_view::npos
+                                                             ? std::string_view::npos
+                                                             : valueEnd - keyEnd - 1);
+        text = valueEnd == std::string_view::npos ? std::string_view() : text.substr(valueEnd + 1);
+
+        int32_t id;
+        if (!parseNumber(key, id)) {
+            id = 0;  // not a number (a newer or modded key): kept as extra
+        }
+
+        int32_t number = 0;
+        bool ok = true;
+        switch (id) {
+        case 1:   ok = parseNumber(value, record.objectID); hasObjectID = ok; break;
+        case 2:   ok = parseNumber(value, record.x); break;
+        case 3:   ok = parseNumber(value, record.y); break;
+        case 6:   ok = parseNumber(value, record.rotation); break;
+        case 21:  ok = parseNumber(value, number); record.mainColor = static_cast<int16_t>(number); break;
+        case 22:  ok = parseNumber(value, number); record.detailColor = static_cast<int16_t>(number); break;
+        case 25:  ok = parseNumber(value, record.zOrder); break;
+        case 57:  ok = parseGroups(value, record); break;
+        case 128: ok = parseNumber(value, record.scaleX); break;
+        case 129: ok = parseNumber(value, record.scaleY); break;
+        case 135: ok = parseNumber(value, number); record.hidden = number != 0; break;
+        default:
+            record.extra.push_back(',');
+            record.extra.append(key);
+            record.extra.push_back(',');
+            record.extra.append(value);
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return hasObjectID;
+}
+
+bool parseObjectStrings(std::string_view text, std::vector<EditorObjectRecord>& out,
+                        std::string* levelHeader) {
+    bool first = true;
+    while (!text.empty()) {
+        size_t end = text.find(';');
+        std::string_view object = text.substr(0, end);
+        if (first && !object.empty() && object[0] == 'k') {
+            if (levelHeader) levelHeader->assign(object);
+        } else if (!object.empty()) {
+            out.emplace_back();
+            if (!parseObjectString(object, out.back())) {
+                out.pop_back();
+                return false;
+            }
+        }
+        if (!object.empty()) first = false;
+        text = end == std::string_view::npos ? std::string_view() : text.substr(end + 1);
+    }
+    return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "main.hpp"
+
+#include <string_view>
+
+// ==============================================
+// EDITOR OBJECT RECORD
+// ==============================================
+//
+// Plain copy of the properties the editor saves for one object. Filled on
+// the main thread (GameObject is cocos2d state and stays there), so encoding
+// and compressing can happen on another thread without touching the level.
+//
+// The text form is GD's object string: comma-separated key,value pairs,
+// defaults omitted, objects joined with ';'.
+//
+//   1 object ID      2 x            3 y            6 rotation
+//   21 main color    22 detail color               25 z order
+//   57 groups ("a.b.c")            128 scale x    129 scale y
+//   135 hidden
+//
+// Any other keys (trigger settings and the like, non-numeric ones too) are
+// kept verbatim in `extra`, so text read in and written back out loses
+// nothing. A whole level string starts with the level header instead of an
+// object ("kS38,...,kA13,0;1,1,2,15,..."); its keys all start with 'k'.
+
+struct EditorObjectRecord {
+    static constexpr int kMaxGroups = 10;
+
+    int32_t uniqueID = 0;      // editor ID; binary saves keep it, text doesn't
+    int32_t objectID = 0;
+    float   x = 0.0f;
+    float   y = 0.0f;
+    float   rotation = 0.0f;
+    float   scaleX = 1.0f;
+    float   scaleY = 1.0f;
+    int32_t zOrder = 0;
+    int16_t mainColor = 0;     // color channel, 0 = object default
+    int16_t detailColor = 0;
+    uint8_t groupCount = 0;
+    bool    hidden = false;
+    int16_t groups[kMaxGroups] = {};
+    std::string extra;         // ",key,value..." pairs not modelled above
+};
+
+// Appends record's object string (without the ';' separator).
+void appendObjectString(const EditorObjectRecord& record, std::string& out);
+// Objects joined with ';'.
+void appendObjectStrings(const std::vector<EditorObjectRecord>& records, std::string& out);
+
+// False if text isn't a well-formed object string (odd pair count, bad
+// number for a modelled key, no object ID).
+bool parseObjectString(std::string_view text, EditorObjectRecord& record);
+// Appends every object of a ';'-joined string; empty segments are skipped.
+// A level header in front is not an object: it is copied to levelHeader
+// when given, skipped otherwise.
+bool parseObjectStrings(std::string_view text, std::vector<EditorObjectRecord>& out,
+                        std::string* levelHeader = nullptr);
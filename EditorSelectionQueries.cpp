@@ -0,0 +1,291 @@
+// EditorSelectionQueries.cpp
+#include "EditorSelectionQueries.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// Maps a float to a uint32_t that sorts the same way (negative values
+// flipped whole, positive ones only in the sign bit).
+uint32_t orderedBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+}
+
+// Stable LSD radix sort on a 32-bit key, 11 bits per pass. A selection
+// sorts up to a few hundred thousand objects, where a comparison sort alone
+// would take most of a frame. Passes whose digit is the same for every item
+// are skipped.
+template <typename T, typename KeyFn>
+void radixSort(std::vector<T>& items, std::vector<T>& scratch, KeyFn key) {
+    constexpr int kDigitBits = 11;
+    constexpr uint32_t kBuckets = 1u << kDigitBits;
+    scratch.resize(items.size());
+    for (int shift = 0; shift < 32; shift += kDigitBits) {
+        uint32_t counts[kBuckets] = {};
+        for (const T& item : items) {
+            ++counts[(key(item) >> shift) & (kBuckets - 1)];
+        }
+        if (items.empty() || counts[(key(items[0]) >> shift) & (kBuckets - 1)] == items.size()) {
+            continue;
+        }
+        uint32_t offset = 0;
+        for (uint32_t& count : counts) {
+            uint32_t bucket = count;
+            count = offset;
+            offset += bucket;
+        }
+        for (const T& item : items) {
+            scratch[counts[(key(item) >> shift) & (kBuckets - 1)]++] = item;
+        }
+        items.swap(scratch);
+    }
+}
+
+} // namespace
+
+// ==============================================
+// POLYGON
+// ==============================================
+
+void SelectionPolygon::assign(const SelectionPoint* points, size_t count, float minSpacing) {
+    m_edgeX.clear();
+    m_edgeY.clear();
+    m_edgeEndY.clear();
+    m_edgeSlope.clear();
+
+    std::vector<SelectionPoint> kept;
+    kept.reserve(count);
+    float spacingSq = minSpacing * minSpacing;
+    for (size_t i = 0; i < count; ++i) {
+        const SelectionPoint& point = points[i];
+        if (!std::isfinite(point.x) || !std::isfinite(point.y)) {
+            continue;
+        }
+        if (!kept.empty()) {
+            float dx = point.x - kept.back().x;
+            float dy = point.y - kept.back().y;
+            if (dx * dx + dy * dy <= spacingSq) {
+                continue;
+            }
+        }
+        kept.push_back(point);
+    }
+    if (kept.size() < 3) {
+        return;
+    }
+
+    m_bounds = {kept[0].x, kept[0].y, kept[0].x, kept[0].y};
+    m_edgeX.reserve(kept.size());
+    m_edgeY.reserve(kept.size());
+    m_edgeEndY.reserve(kept.size());
+    m_edgeSlope.reserve(kept.size());
+    for (size_t i = 0; i < kept.size(); ++i) {
+        const SelectionPoint& from = kept[i];
+        const SelectionPoint& to = kept[(i + 1) % kept.size()];
+        m_edgeX.push_back(from.x);
+        m_edgeY.push_back(from.y);
+        m_edgeEndY.push_back(to.y);
+        m_edgeSlope.push_back(to.y != from.y ? (to.x - from.x) / (to.y - from.y) : 0.0f);
+
+        m_bounds.minX = std::min(m_bounds.minX, from.x);
+        m_bounds.minY = std::min(m_bounds.minY, from.y);
+        m_bounds.maxX = std::max(m_bounds.maxX, from.x);
+        m_bounds.maxY = std::max(m_bounds.maxY, from.y);
+    }
+}
+
+void SelectionPolygon::containsPoints(const float* __restrict xs, const float* __restrict ys, size_t count,
+                                      uint8_t* __restrict inside) const {
+    std::fill(inside, inside + count, uint8_t(0));
+
+    for (size_t edge = 0; edge < m_edgeX.size(); ++edge) {
+        const float x0 = m_edgeX[edge];
+        const float y0 = m_edgeY[edge];
+        const float slope = m_edgeSlope[edge];
+
+        // The rightward ray from a point crosses the edge only if the point's
+        // y is in [min(y0, y1), max(y0, y1)); with ys sorted that is one
+        // contiguous band, found by binary search. Lasso edges are short, so
+        // most points are never looked at for most edges.
+        const float bandLow = std::min(y0, m_edgeEndY[edge]);
+        const float bandHigh = std::max(y0, m_edgeEndY[edge]);
+        const size_t begin = std::lower_bound(ys, ys + count, bandLow) - ys;
+        const size_t end = std::lower_bound(ys + begin, ys + count, bandHigh) - ys;
+
+        // Branch-free over flat, non-aliasing arrays. At -O2 GCC only
+        // vectorizes a loop that needs no scalar epilogue, so the band is
+        // walked in fixed kLaneBlock-point blocks (one 16-byte vector of
+        // results each) and the remainder finished one point at a time.
+        const size_t bandCount = end - begin;
+        const size_t blocks = bandCount / kLaneBlock;
+        for (size_t block = 0; block < blocks; ++block) {
+            const size_t first = begin + block * kLaneBlock;
+            const float* __restrict blockX = xs + first;
+            const float* __restrict blockY = ys + first;
+            uint8_t* __restrict blockInside = inside + first;
+            for (size_t i = 0; i < kLaneBlock; ++i) {
+                blockInside[i] ^= uint8_t(blockX[i] < x0 + slope * (blockY[i] - y0));
+            }
+        }
+        for (size_t i = begin + blocks * kLaneBlock; i < end; ++i) {
+            inside[i] ^= uint8_t(xs[i] < x0 + slope * (ys[i] - y0));
+        }
+    }
+}
+
+// ==============================================
+// LASSO / POLYGON SELECTION
+// ==============================================
+
+void EditorSelectionQueries::insidePolygon(const EditorSpatialIndex& index, const SelectionPolygon& polygon,
+                                           std::vector<uint32_t>& out) {
+    out.clear();
+    if (!polygon.isValid()) {
+        return;
+    }
+
+    // Candidates: objects whose center is inside the polygon's bounding
+    // box, ordered by center y. They are read from the cells' own copies of
+    // the bounds, in cell order; an object filed in several cells is taken
+    // only from the one holding its center.
+    const BroadPhaseRect& area = polygon.bounds();
+    m_byY.clear();
+    auto centered = [&](float x, float y) {
+        return x >= area.minX && x <= area.maxX && y >= area.minY && y <= area.maxY;
+    };
+    index.forEachCell(area, [&](uint64_t key, const std::vector<EditorSpatialIndex::CellItem>& items) {
+        const int32_t column = int32_t(uint32_t(key >> 32));
+        const int32_t row = int32_t(uint32_t(key));
+        for (const EditorSpatialIndex::CellItem& item : items) {
+            float x = (item.bounds.minX + item.bounds.maxX) * 0.5f;
+            float y = (item.bounds.minY + item.bounds.maxY) * 0.5f;
+            if (centered(x, y) && EditorSpatialIndex::cellFor(x) == column && EditorSpatialIndex::cellFor(y) == row) {
+                m_byY.push_back({y, x, item.handle});
+            }
+        }
+    });
+    for (uint32_t handle : index.oversized()) {
+        const BroadPhaseRect& rect = index.bounds(handle);
+        float x = (rect.minX + rect.maxX) * 0.5f;
+        float y = (rect.minY + rect.maxY) * 0.5f;
+        if (centered(x, y)) {
+            m_byY.push_back({y, x, handle});
+        }
+    }
+    radixSort(m_byY, m_byYScratch, [](const Center& center) { return orderedBits(center.y); });
+
+    size_t count = m_byY.size();
+    m_centerX.resize(count);
+    m_centerY.resize(count);
+    m_inside.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        m_centerX[i] = m_byY[i].x;
+        m_centerY[i] = m_byY[i].y;
+    }
+
+    polygon.containsPoints(m_centerX.data(), m_centerY.data(), count, m_inside.data());
+
+    for (size_t i = 0; i < count; ++i) {
+        if (m_inside[i]) {
+            out.push_back(m_byY[i].handle);
+        }
+    }
+    radixSort(out, m_sortScratch, [](uint32_t handle) { return handle; });
+}
+
+// ==============================================
+// MAGIC WAND
+// ==============================================
+
+bool EditorSelectionQueries::magicWand(const EditorSpatialIndex& index, uint32_t seed, float gap,
+                                       const SimilarFn& similar, std::vector<uint32_t>& out,
+                                       size_t maxCount) {
+    out.clear();
+    if (!index.contains(seed) || maxCount == 0) {
+        return true;
+    }
+    if (m_state.size() < index.capacity()) {
+        m_state.resize(index.capacity(), kUnjudged);
+    }
+
+    // Each cell the flood reaches gets a private list of its similar,
+    // not-yet-selected objects, built the first time the cell is touched.
+    // Selected objects are dropped from the lists as they are found, so
+    // later neighbour checks only scan what is still left to claim.
+    auto judge = [&](uint32_t handle) {
+        if (m_state[handle] == kUnjudged) {
+            m_state[handle] = similar(seed, handle) ? kCandidate : kRejected;
+            m_judged.push_back(handle);
+        }
+        return m_state[handle];
+    };
+    bool truncated = false;
+    auto claim = [&](std::vector<EditorSpatialIndex::CellItem>& items, const BroadPhaseRect& area) {
+        for (size_t i = 0; i < items.size();) {
+            const EditorSpatialIndex::CellItem& item = items[i];
+            bool taken = m_state[item.handle] == kSelected;
+            if (!taken && item.bounds.intersects(area)) {
+                if (out.size() >= maxCount) {
+                    truncated = true;
+                    return;
+                }
+                m_state[item.handle] = kSelected;
+                out.push_back(item.handle);
+                taken = true;
+            }
+            if (taken) {
+                items[i] = items.back();
+                items.pop_back();
+            } else {
+                ++i;
+            }
+        }
+    };
+
+    m_pendingCells.clear();
+    m_pendingUsed = 0;
+    m_pendingOversized.clear();
+    for (uint32_t handle : index.oversized()) {
+        if (handle != seed && judge(handle) == kCandidate) {
+            m_pendingOversized.push_back({index.bounds(handle), handle});
+        }
+    }
+
+    m_state[seed] = kSelected;
+    m_judged.push_back(seed);
+    out.push_back(seed);
+
+    // out doubles as the BFS queue: [0, head) expanded, [head, end) pending.
+    for (size_t head = 0; head < out.size() && !truncated; ++head) {
+        const BroadPhaseRect& rect = index.bounds(out[head]);
+        BroadPhaseRect area{rect.minX - gap, rect.minY - gap, rect.maxX + gap, rect.maxY + gap};
+
+        index.forEachCell(area, [&](uint64_t key, const std::vector<EditorSpatialIndex::CellItem>& items) {
+            auto slot = m_pendingCells.try_emplace(key, uint32_t(m_pendingUsed));
+            if (slot.second) {
+                if (m_pendingUsed == m_pendingLists.size()) {
+                    m_pendingLists.emplace_back();
+                }
+                std::vector<EditorSpatialIndex::CellItem>& pending = m_pendingLists[m_pendingUsed++];
+                pending.clear();
+                for (const EditorSpatialIndex::CellItem& item : items) {
+                    if (judge(item.handle) == kCandidate) {
+                        pending.push_back(item);
+                    }
+                }
+            }
+            claim(m_pendingLists[slot.first->second], area);
+        });
+        claim(m_pendingOversized, area);
+    }
+
+    for (uint32_t handle : m_judged) m_state[handle] = kUnjudged;
+    m_judged.clear();
+
+    radixSort(out, m_sortScratch, [](uint32_t handle) { return handle; });
+    return !truncated;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "main.hpp"
+#include "EditorSpatialIndex.hpp"
+
+#include <functional>
+
+// ==============================================
+// EDITOR SELECTION QUERIES
+// ==============================================
+//
+// Lasso, polygon and magic-wand selection over EditorSpatialIndex handles.
+//
+// Polygon/lasso: the polygon's bounding box goes through the index first,
+// then the surviving objects' centers are copied into flat x/y arrays sorted
+// by y. Each edge only tests the band of points whose y it spans (even-odd
+// rule), in a branch-free loop GCC vectorizes at -O2.
+//
+// Magic wand: breadth-first flood from the object under the cursor through
+// objects within `gap` of one already selected that the caller's predicate
+// accepts. The cost follows the size of the selected region, not of the
+// level.
+
+struct SelectionPoint {
+    float x, y;
+};
+
+class SelectionPolygon {
+public:
+    // Points per block of containsPoints' inner loop: one 16-byte vector of
+    // uint8_t results.
+    static constexpr size_t kLaneBlock = 16;
+
+    // Closes the outline implicitly. Points closer than minSpacing to the
+    // previous kept point are dropped (freehand lassos report one point per
+    // touch move, most of them a pixel apart).
+    void assign(const SelectionPoint* points, size_t count, float minSpacing = 0.0f);
+
+    bool isValid() const { return m_edgeX.size() >= 3; }
+    size_t edgeCount() const { return m_edgeX.size(); }
+    const BroadPhaseRect& bounds() const { return m_bounds; }
+
+    // inside[i] = 1 if (xs[i], ys[i]) lies inside the polygon, else 0.
+    // ys must be sorted ascending; the arrays must not overlap.
+    void containsPoints(const float* __restrict xs, const float* __restrict ys, size_t count,
+                        uint8_t* __restrict inside) const;
+
+private:
+    // Per edge: start point, end y and dx/dy (0 for horizontal edges, which
+    // never cross a scanline).
+    std::vector<float> m_edgeX, m_edgeY, m_edgeEndY, m_edgeSlope;
+    BroadPhaseRect m_bounds{0.0f, 0.0f, 0.0f, 0.0f};
+};
+
+class EditorSelectionQueries {
+public:
+    // (seed handle, candidate handle) -> candidate belongs to the selection
+    using SimilarFn = std::function<bool(uint32_t seed, uint32_t candidate)>;
+
+    // Handles whose bounds center lies inside polygon, ascending.
+    void insidePolygon(const EditorSpatialIndex& index, const SelectionPolygon& polygon,
+                       std::vector<uint32_t>& out);
+
+    // Flood from seed (included) through objects whose bounds come within
+    // gap of an already selected object and that similar() accepts.
+    // Stops after maxCount objects; returns false if it had to.
+    bool magicWand(const EditorSpatialIndex& index, uint32_t seed, float gap,
+                   const SimilarFn& similar, std::vector<uint32_t>& out,
+                   size_t maxCount = SIZE_MAX);
+
+private:
+    enum : uint8_t { kUnjudged = 0, kCandidate, kRejected, kSelected };
+
+    struct Center {
+        float y, x;
+        uint32_t handle;
+    };
+
+    std::vector<Center> m_byY, m_byYScratch;
+    std::vector<uint32_t> m_sortScratch;
+    std::vector<float> m_centerX, m_centerY;
+    std::vector<uint8_t> m_inside;
+
+    // Magic wand scratch; m_state is indexed by handle and reset through
+    // m_judged, so a small flood doesn't pay for the level's size.
+    std::vector<uint8_t> m_state;
+    std::vector<uint32_t> m_judged;
+    // Cell key -> its list in m_pendingLists. The lists are kept between
+    // floods (only the first m_pendingUsed are live) so their storage is
+    // reused instead of reallocated for every cell.
+    std::unordered_map<uint64_t, uint32_t> m_pendingCells;
+    std::vector<std::vector<EditorSpatialIndex::CellItem>> m_pendingLists;
+    size_t m_pendingUsed = 0;
+    std::vector<EditorSpatialIndex::CellItem> m_pendingOversized;
+};
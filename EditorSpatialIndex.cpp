@@ -0,0 +1,218 @@
+// EditorSpatialIndex.cpp
+#include "EditorSpatialIndex.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// ==============================================
+// CELLS
+// ==============================================
+
+int32_t EditorSpatialIndex::cellFor(float coordinate) {
+    // Clamp before converting so far-off (or NaN) positions still land in a
+    // valid cell instead of overflowing the int.
+    float cell = std::floor(coordinate / kCellSize);
+    if (!(cell > -1.0e9f)) return -1000000000;
+    if (cell > 1.0e9f) return 1000000000;
+    return static_cast<int32_t>(cell);
+}
+
+EditorSpatialIndex::CellSpan EditorSpatialIndex::spanFor(const BroadPhaseRect& bounds) {
+    return {cellFor(bounds.minX), cellFor(bounds.minY), cellFor(bounds.maxX), cellFor(bounds.maxY)};
+}
+
+bool EditorSpatialIndex::isOversized(const CellSpan& span) {
+    uint64_t columns = uint64_t(int64_t(span.maxX) - span.minX + 1);
+    uint64_t rows = uint64_t(int64_t(span.maxY) - span.minY + 1);
+    return columns * rows > kMaxCellsPerEntry;
+}
+
+void EditorSpatialIndex::file(uint32_t handle) {
+    Entry& entry = m_entries[handle];
+    entry.span = spanFor(entry.bounds);
+    entry.oversized = isOversized(entry.span);
+
+    if (entry.oversized) {
+        m_oversized.push_back(handle);
+        return;
+    }
+
+    for (int32_t x = entry.span.minX; x <= entry.span.maxX; ++x) {
+        for (int32_t y = entry.span.minY; y <= entry.span.maxY; ++y) {
+            m_cells[cellKey(x, y)].push_back({entry.bounds, handle});
+        }
+    }
+    m_extent.minX = std::min(m_extent.minX, entry.span.minX);
+    m_extent.minY = std::min(m_extent.minY, entry.span.minY);
+    m_extent.maxX = std::max(m_extent.maxX, entry.span.maxX);
+    m_extent.maxY = std::max(m_extent.maxY, entry.span.maxY);
+}
+
+void EditorSpatialIndex::unfile(uint32_t handle) {
+    Entry& entry = m_entries[handle];
+
+    // Order inside a cell doesn't matter (queries sort), so swap-and-pop.
+    if (entry.oversized) {
+        auto it = std::find(m_oversized.begin(), m_oversized.end(), handle);
+        if (it != m_oversized.end()) {
+            *it = m_oversized.back();
+            m_oversized.pop_back();
+        }
+        return;
+    }
+
+    for (int32_t x = entry.span.minX; x <= entry.span.maxX; ++x) {
+        for (int32_t y = entry.span.minY; y <= entry.span.maxY; ++y) {
+            auto cell = m_cells.find(cellKey(x, y));
+            if (cell == m_cells.end()) {
+                continue;
+            }
+            std::vector<CellItem>& items = cell->second;
+            auto it = std::find_if(items.begin(), items.end(),
+                                   [handle](const CellItem& item) { return item.handle == handle; });
+            if (it != items.end()) {
+                *it = items.back();
+                items.pop_back();
+            }
+            if (items.empty()) {
+                m_cells.erase(cell);
+            }
+        }
+    }
+}
+
+// ==============================================
+// INSERT / UPDATE / REMOVE
+// ==============================================
+
+uint32_t EditorSpatialIndex::insert(const BroadPhaseRect& bounds) {
+    uint32_t handle;
+    if (!m_freeHandles.empty()) {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+    } else {
+        handle = static_cast<uint32_t>(m_entries.size());
+        m_entries.emplace_back();
+        m_stamps.push_back(0);
+    }
+
+    Entry& entry = m_entries[handle];
+    entry.bounds = bounds;
+    entry.live = true;
+    file(handle);
+    ++m_liveCount;
+    return handle;
+}
+
+void EditorSpatialIndex::update(uint32_t handle, const BroadPhaseRect& bounds) {
+    if (!contains(handle)) {
+        return;
+    }
+
+    Entry& entry = m_entries[handle];
+    CellSpan span = spanFor(bounds);
+    if (span == entry.span) {
+        // Nudges, small rotations and most scales stay inside the same cells;
+        // only the copies of the bounds need rewriting.
+        entry.bounds = bounds;
+        if (!entry.oversized) {
+            for (int32_t x = span.minX; x <= span.maxX; ++x) {
+                for (int32_t y = span.minY; y <= span.maxY; ++y) {
+                    for (CellItem& item : m_cells[cellKey(x, y)]) {
+                        if (item.handle == handle) {
+                            item.bounds = bounds;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        return;
+    }
+
+    unfile(handle);
+    entry.bounds = bounds;
+    file(handle);
+}
+
+void EditorSpatialIndex::remove(uint32_t handle) {
+    if (!contains(handle)) {
+        return;
+    }
+    unfile(handle);
+    m_entries[handle].live = false;
+    m_freeHandles.push_back(handle);
+    --m_liveCount;
+}
+
+void EditorSpatialIndex::clear() {
+    m_entries.clear();
+    m_freeHandles.clear();
+    m_oversized.clear();
+    m_cells.clear();
+    m_stamps.clear();
+    m_generation = 0;
+    m_liveCount = 0;
+    m_extent = {INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN};
+}
+
+void EditorSpatialIndex::reserve(size_t count) {
+    m_entries.reserve(count);
+    m_stamps.reserve(count);
+    m_cells.reserve(count / 4);
+}
+
+// ==============================================
+// QUERIES
+// ==============================================
+
+void EditorSpatialIndex::beginQuery() const {
+    if (++m_generation == 0) {
+        // Stamp wrap-around: reset so stale stamps can't match.
+        std::fill(m_stamps.begin(), m_stamps.end(), 0);
+        m_generation = 1;
+    }
+}
+
+void EditorSpatialIndex::queryRect(const BroadPhaseRect& area, std::vector<uint32_t>& out) const {
+    queryRectUnordered(area, out);
+    std::sort(out.begin(), out.end());
+}
+
+void EditorSpatialIndex::queryRectUnordered(const BroadPhaseRect& area, std::vector<uint32_t>& out) const {
+    out.clear();
+    beginQuery();
+
+    // Bounds are read from the cell's own copy, so a cell is one contiguous
+    // scan; the stamp is only touched for actual hits.
+    forEachCell(area, [&](uint64_t, const std::vector<CellItem>& items) {
+        for (const CellItem& item : items) {
+            // Non-short-circuit & keeps the per-item test branch-free.
+            const bool hit = (item.bounds.minX <= area.maxX) & (item.bounds.maxX >= area.minX) &
+                             (item.bounds.minY <= area.maxY) & (item.bounds.maxY >= area.minY);
+            if (hit && m_stamps[item.handle] != m_generation) {
+                m_stamps[item.handle] = m_generation;
+                out.push_back(item.handle);
+            }
+        }
+    });
+
+    for (uint32_t handle : m_oversized) {
+        if (m_entries[handle].bounds.intersects(area)) {
+            out.push_back(handle);  // never filed in a cell, so never a duplicate
+        }
+    }
+}
+
+void EditorSpatialIndex::queryRadius(float x, float y, float radius, std::vector<uint32_t>& out) const {
+    queryRect({x - radius, y - radius, x + radius, y + radius}, out);
+
+    // Narrow the box hits down to bounds within radius of the point.
+    float radiusSq = radius * radius;
+    out.erase(std::remove_if(out.begin(), out.end(), [&](uint32_t handle) {
+        const BroadPhaseRect& rect = m_entries[handle].bounds;
+        float dx = std::max({rect.minX - x, 0.0f, x - rect.maxX});
+        float dy = std::max({rect.minY - y, 0.0f, y - rect.maxY});
+        return dx * dx + dy * dy > radiusSq;
+    }), out.end());
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "main.hpp"
+#include "CollisionBroadPhase.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+// ==============================================
+// EDITOR SPATIAL INDEX
+// ==============================================
+//
+// Dynamic bucketed grid over every object in the editor, so hit tests and
+// rect/radius queries only look at the objects near the area instead of the
+// whole level. Unlike CollisionBroadPhase (built once per attempt), objects
+// here move, rotate and scale all the time, so cells are hashed and each
+// entry remembers the cell span it was filed under: an update that stays in
+// the same cells only rewrites the bounds.
+//
+// Objects covering more than kMaxCellsPerEntry cells (huge scaled
+// decorations, full-screen triggers) are kept in a short "oversized" list
+// that every query scans, rather than being copied into hundreds of cells.
+//
+// Handles are dense and reused after remove(). Queries return each handle
+// at most once, in ascending order. Main thread only: the "already
+// reported" stamps are shared by all queries.
+
+class EditorSpatialIndex {
+public:
+    static constexpr float    kCellSize = 120.0f;    // four grid blocks
+    static constexpr uint32_t kMaxCellsPerEntry = 64;
+    static constexpr uint32_t kInvalidHandle = UINT32_MAX;
+
+    uint32_t insert(const BroadPhaseRect& bounds);
+    void update(uint32_t handle, const BroadPhaseRect& bounds);
+    void remove(uint32_t handle);
+    void clear();
+    void reserve(size_t count);
+
+    bool contains(uint32_t handle) const { return handle < m_entries.size() && m_entries[handle].live; }
+    const BroadPhaseRect& bounds(uint32_t handle) const { return m_entries[handle].bounds; }
+    size_t size() const { return m_liveCount; }
+    // One past the highest handle ever issued (for per-handle side arrays).
+    size_t capacity() const { return m_entries.size(); }
+
+    // Every handle whose bounds intersect area.
+    void queryRect(const BroadPhaseRect& area, std::vector<uint32_t>& out) const;
+    // Same hits in cell order, for callers that don't need them sorted.
+    void queryRectUnordered(const BroadPhaseRect& area, std::vector<uint32_t>& out) const;
+    // Every handle whose bounds come within radius of (x, y).
+    void queryRadius(float x, float y, float radius, std::vector<uint32_t>& out) const;
+
+    // Cells keep their own copy of each object's bounds.
+    struct CellItem {
+        BroadPhaseRect bounds;
+        uint32_t handle;
+    };
+
+    // Raw cell access for searches that keep per-cell state of their own
+    // (the magic wand). fn(cellKey, items) runs once for every occupied cell
+    // overlapping area; an object spanning several cells shows up in each.
+    // Oversized objects live in no cell, see oversized().
+    template <typename Fn>
+    void forEachCell(const BroadPhaseRect& area, Fn&& fn) const;
+    const std::vector<uint32_t>& oversized() const { return m_oversized; }
+    // Cell column/row of a coordinate; the key forEachCell passes packs
+    // column << 32 | row.
+    static int32_t cellFor(float coordinate);
+
+private:
+    struct CellSpan {
+        int32_t minX, minY, maxX, maxY;
+        bool operator==(const CellSpan& other) const {
+            return minX == other.minX && minY == other.minY && maxX == other.maxX && maxY == other.maxY;
+        }
+    };
+
+    struct Entry {
+        BroadPhaseRect bounds;
+        CellSpan span;
+        bool live = false;
+        bool oversized = false;
+    };
+
+    static CellSpan spanFor(const BroadPhaseRect& bounds);
+    static uint64_t cellKey(int32_t x, int32_t y) {
+        return (uint64_t(uint32_t(x)) << 32) | uint32_t(y);
+    }
+    static bool isOversized(const CellSpan& span);
+
+    void file(uint32_t handle);
+    void unfile(uint32_t handle);
+    void beginQuery() const;
+
+    std::vector<Entry> m_entries;
+    std::vector<uint32_t> m_freeHandles;
+    std::vector<uint32_t> m_oversized;
+    std::unordered_map<uint64_t, std::vector<CellItem>> m_cells;
+    size_t m_liveCount = 0;
+
+    // Union of every span ever filed (shrinks only on clear); queries clamp
+    // to it so a select-all rect doesn't walk empty cells.
+    CellSpan m_extent{INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN};
+
+    mutable std::vector<uint32_t> m_stamps;
+    mutable uint32_t m_generation = 0;
+};
+
+template <typename Fn>
+void EditorSpatialIndex::forEachCell(const BroadPhaseRect& area, Fn&& fn) const {
+    CellSpan span = spanFor(area);
+    span.minX = std::max(span.minX, m_extent.minX);
+    span.minY = std::max(span.minY, m_extent.minY);
+    span.maxX = std::min(span.maxX, m_extent.maxX);
+    span.maxY = std::min(span.maxY, m_extent.maxY);
+    if (span.minX > span.maxX || span.minY > span.maxY) {
+        return;
+    }
+
+    uint64_t cellCount = uint64_t(int64_t(span.maxX) - span.minX + 1) *
+                         uint64_t(int64_t(span.maxY) - span.minY + 1);
+    if (cellCount > m_cells.size()) {
+        // Area covers more cells than are occupied: walk the occupied ones.
+        for (const auto& cell : m_cells) {
+            int32_t x = int32_t(uint32_t(cell.first >> 32));
+            int32_t y = int32_t(uint32_t(cell.first));
+            if (x >= span.minX && x <= span.maxX && y >= span.minY && y <= span.maxY) {
+                fn(cell.first, cell.second);
+            }
+        }
+        return;
+    }
+
+    for (int32_t x = span.minX; x <= span.maxX; ++x) {
+        for (int32_t y = span.minY; y <= span.maxY; ++y) {
+            auto cell = m_cells.find(cellKey(x, y));
+            if (cell != m_cells.end()) {
+                fn(cell->first, cell->second);
+            }
+        }
+    }
+}
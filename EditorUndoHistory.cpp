@@ -0,0 +1,658 @@
+// EditorUndoHistory.cpp
+#include "EditorUndoHistory.hpp"
+#include "ByteStream.hpp"
+#include "EditorUndoLog.hpp"
+
+#include <algorithm>
+
+// ==============================================
+// ID SETS
+// ==============================================
+//
+// ids (sorted, unique) are stored one of two ways, whichever is smaller:
+//   0, varint run count, per run varint(gap from the previous run's end)
+//      and varint(length - 1)           -- objects placed together
+//   1, signed first ID, varint span, span bits (LSB first)
+//                                       -- scattered lasso/wand selections
+
+static constexpr uint8_t kIDRuns = 0;
+static constexpr uint8_t kIDBitmap = 1;
+
+static void sortUnique(std::vector<int>& ids) {
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+static void writeIDSet(ByteWriter& writer, const std::vector<int>& sortedIDs) {
+    std::vector<uint8_t> runs;
+    ByteWriter runWriter(runs);
+    size_t runCount = 0;
+    for (size_t i = 0; i < sortedIDs.size(); ++i) {
+        if (i == 0 || sortedIDs[i] != sortedIDs[i - 1] + 1) ++runCount;
+    }
+    runWriter.putVarint(runCount);
+    int64_t previousEnd = 0;
+    for (size_t i = 0; i < sortedIDs.size();) {
+        size_t runEnd = i + 1;
+        while (runEnd < sortedIDs.size() && sortedIDs[runEnd] == sortedIDs[runEnd - 1] + 1) ++runEnd;
+        runWriter.putSigned(int64_t(sortedIDs[i]) - previousEnd);
+        runWriter.putVarint(runEnd - i - 1);
+        previousEnd = int64_t(sortedIDs[runEnd - 1]) + 1;
+        i = runEnd;
+    }
+
+    uint64_t span = uint64_t(int64_t(sortedIDs.back()) - sortedIDs.front() + 1);
+    if (span / 8 + 8 < runs.size()) {
+        std::vector<uint8_t> bits((span + 7) / 8, 0);
+        for (int id : sortedIDs) {
+            uint64_t bit = uint64_t(int64_t(id) - sortedIDs.front());
+            bits[bit / 8] |= uint8_t(1u << (bit % 8));
+        }
+        writer.putByte(kIDBitmap);
+        writer.putSigned(sortedIDs.front());
+        writer.putVarint(span);
+        writer.putBytes(bits.data(), bits.size());
+        return;
+    }
+
+    writer.putByte(kIDRuns);
+    writer.putBytes(runs.data(), runs.size());
+}
+
+static std::vector<int> readIDSet(ByteReader& reader) {
+    std::vector<int> ids;
+    uint8_t encoding = reader.getByte();
+
+    if (encoding == kIDBitmap) {
+        int64_t first = reader.getSigned();
+        uint64_t span = reader.getVarint();
+        std::string_view bits = reader.getBytes(static_cast<size_t>((span + 7) / 8));
+        if (reader.failed()) return ids;
+        for (uint64_t bit = 0; bit < span; ++bit) {
+            if (uint8_t(bits[bit / 8]) & (1u << (bit % 8))) ids.push_back(static_cast<int>(first + int64_t(bit)));
+        }
+        return ids;
+    }
+
+    uint64_t runCount = reader.getVarint();
+    int64_t previousEnd = 0;
+    for (uint64_t run = 0; run < runCount && !reader.failed(); ++run) {
+        int64_t start = previousEnd + reader.getSigned();
+        uint64_t length = reader.getVarint() + 1;
+        if (reader.failed() || length > uint64_t(INT32_MAX)) break;
+        for (uint64_t i = 0; i < length; ++i) ids.push_back(static_cast<int>(start + int64_t(i)));
+        previousEnd = start + int64_t(length);
+    }
+    return ids;
+}
+
+// ==============================================
+// RECORDING
+// ==============================================
+
+EditorUndoHistory::Entry& EditorUndoHistory::openEntry() {
+    if (!m_hasOpen) {
+        m_open = Entry();
+        m_open.description = std::move(m_nextDescription);
+        m_nextDescription.clear();
+        m_hasOpen = true;
+        m_bytesUsed += m_open.byteSize();
+    }
+    return m_open;
+}
+
+void EditorUndoHistory::closeEntry() {
+    if (!m_hasOpen) {
+        return;
+    }
+    m_hasOpen = false;
+    m_bytesUsed -= m_open.byteSize();
+    if (m_open.offsets.empty()) {
+        return;
+    }
+    m_open.commands.shrink_to_fit();
+    m_open.offsets.shrink_to_fit();
+    m_bytesUsed += m_open.byteSize();
+    pushUndo(std::move(m_open));
+}
+
+void EditorUndoHistory::appendCommand(CommandType type, const std::vector<int>& sortedIDs,
+                                      const std::vector<uint8_t>& payload) {
+    if (sortedIDs.empty()) {
+        return;
+    }
+
+    // A new change invalidates everything that could be redone.
+    clearRedo();
+
+    Entry& entry = openEntry();
+    std::vector<uint8_t> ids;
+    ByteWriter idWriter(ids);
+    writeIDSet(idWriter, sortedIDs);
+
+    // Fold into the previous command when it is the same kind of change to
+    // the same objects (only within an open group).
+    bool sameIDs = m_groupDepth > 0 && !entry.offsets.empty() && m_lastType == type &&
+                   m_lastIDsEnd - m_lastIDsBegin == ids.size() &&
+                   std::equal(ids.begin(), ids.end(), entry.commands.begin() + m_lastIDsBegin);
+    if (sameIDs) {
+        uint8_t* last = entry.commands.data() + m_lastIDsEnd;
+        ByteReader previous(last, entry.commands.size() - m_lastIDsEnd);
+        ByteReader next(payload.data(), payload.size());
+        std::vector<uint8_t> merged;
+        ByteWriter writer(merged);
+
+        switch (type) {
+        case CommandType::Translate: {
+            float a0 = previous.getFloat(), a1 = previous.getFloat();
+            float b0 = next.getFloat(), b1 = next.getFloat();
+            writer.putFloat(a0 + b0);
+            writer.putFloat(a1 + b1);
+            std::copy(merged.begin(), merged.end(), last);
+            return;
+        }
+        case CommandType::Rotate:
+            writer.putFloat(previous.getFloat() + next.getFloat());
+            std::copy(merged.begin(), merged.end(), last);
+            return;
+        case CommandType::Property: {
+            // Same property: keep the first old values, take the new value.
+            uint64_t previousProperty = previous.getVarint();
+            uint64_t nextProperty = next.getVarint();
+            if (previousProperty == nextProperty) {
+                size_t valueOffset = previous.position() - entry.commands.data();
+                float newValue = next.getFloat();
+                writer.putFloat(newValue);
+                std::copy(merged.begin(), merged.end(), entry.commands.begin() + valueOffset);
+                return;
+            }
+            break;
+        }
+        case CommandType::Modify: {
+            // Keep the first old state, take the new one; the payload
+            // changes length, so it is rewritten at the end of the entry.
+            writer.putString(previous.getString());
+            next.getString();
+            writer.putString(next.getString());
+            m_bytesUsed -= entry.byteSize();
+            entry.commands.resize(m_lastIDsEnd);
+            entry.commands.insert(entry.commands.end(), merged.begin(), merged.end());
+            m_bytesUsed += entry.byteSize();
+            return;
+        }
+        default:
+            break;
+        }
+    }
+
+    m_bytesUsed -= entry.byteSize();
+    entry.offsets.push_back(static_cast<uint32_t>(entry.commands.size()));
+    entry.commands.push_back(static_cast<uint8_t>(type));
+    m_lastType = type;
+    m_lastIDsBegin = entry.commands.size();
+    entry.commands.insert(entry.commands.end(), ids.begin(), ids.end());
+    m_lastIDsEnd = entry.commands.size();
+    entry.commands.insert(entry.commands.end(), payload.begin(), payload.end());
+    m_bytesUsed += entry.byteSize();
+
+    if (m_groupDepth == 0) {
+        closeEntry();
+    }
+}
+
+void EditorUndoHistory::recordTranslate(std::vector<int> ids, float dx, float dy) {
+    if (dx == 0.0f && dy == 0.0f) return;
+    sortUnique(ids);
+    std::vector<uint8_t> payload;
+    ByteWriter writer(payload);
+    writer.putFloat(dx);
+    writer.putFloat(dy);
+    appendCommand(CommandType::Translate, ids, payload);
+}
+
+void EditorUndoHistory::recordRotate(std::vector<int> ids, float degrees) {
+    if (degrees == 0.0f) return;
+    sortUnique(ids);
+    std::vector<uint8_t> payload;
+    ByteWriter writer(payload);
+    writer.putFloat(degrees);
+    appendCommand(CommandType::Rotate, ids, payload);
+}
+
+void EditorUndoHistory::recordProperty(const std::vector<int>& ids, UndoProperty property,
+                                       const std::vector<float>& oldValues, float newValue) {
+    if (ids.size() != oldValues.size()) return;
+
+    std::vector<std::pair<int, float>> byID;
+    byID.reserve(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i) byID.emplace_back(ids[i], oldValues[i]);
+    std::sort(byID.begin(), byID.end(),
+              [](const std::pair<int, float>& a, const std::pair<int, float>& b) { return a.first < b.first; });
+    byID.erase(std::unique(byID.begin(), byID.end(),
+                           [](const std::pair<int, float>& a, const std::pair<int, float>& b) {
+                               return a.first == b.first;
+                           }),
+               byID.end());
+
+    std::vector<int> sortedIDs;
+    sortedIDs.reserve(byID.size());
+    for (const auto& item : byID) sortedIDs.push_back(item.first);
+
+    // property, new value, then old values as (count, value) runs: a
+    // selection that all shared the old value is one run.
+    std::vector<uint8_t> payload;
+    ByteWriter writer(payload);
+    writer.putVarint(static_cast<uint16_t>(property));
+    writer.putFloat(newValue);
+    size_t runCount = 0;
+    for (size_t i = 0; i < byID.size(); ++i) {
+        if (i == 0 || byID[i].second != byID[i - 1].second) ++runCount;
+    }
+    writer.putVarint(runCount);
+    for (size_t i = 0; i < byID.size();) {
+        size_t runEnd = i + 1;
+        while (runEnd < byID.size() && byID[runEnd].second == byID[i].second) ++runEnd;
+        writer.putVarint(runEnd - i);
+        writer.putFloat(byID[i].second);
+        i = runEnd;
+    }
+    appendCommand(CommandType::Property, sortedIDs, payload);
+}
+
+void EditorUndoHistory::recordCreate(std::vector<int> ids, std::string_view objectString) {
+    sortUnique(ids);
+    std::vector<uint8_t> payload;
+    ByteWriter writer(payload);
+    writer.putString(objectString);
+    appendCommand(CommandType::Create, ids, payload);
+}
+
+void EditorUndoHistory::recordRemove(std::vector<int> ids, std::string_view objectString) {
+    sortUnique(ids);
+    std::vector<uint8_t> payload;
+    ByteWriter writer(payload);
+    writer.putString(objectString);
+    appendCommand(CommandType::Remove, ids, payload);
+}
+
+void EditorUndoHistory::recordModify(std::vector<int> ids, std::string_view oldObjects,
+                                     std::string_view newObjects) {
+    if (oldObjects == newObjects) return;
+    sortUnique(ids);
+    std::vector<uint8_t> payload;
+    ByteWriter writer(payload);
+    writer.putString(oldObjects);
+    writer.putString(newObjects);
+    appendCommand(CommandType::Modify, ids, payload);
+}
+
+// ==============================================
+// GROUPS
+// ==============================================
+
+void EditorUndoHistory::beginGroup(std::string_view description) {
+    if (m_groupDepth++ == 0) {
+        closeEntry();
+        m_nextDescription = description;
+        openEntry();
+    }
+}
+
+void EditorUndoHistory::endGroup() {
+    if (m_groupDepth == 0) {
+        return;
+    }
+    if (--m_groupDepth == 0) {
+        closeEntry();
+    }
+}
+
+void EditorUndoHistory::cancelGroup(EditorUndoTarget& target) {
+    if (m_groupDepth == 0) {
+        return;
+    }
+    m_groupDepth = 0;
+    if (m_hasOpen) {
+        apply(m_open, target, true);
+        m_bytesUsed -= m_open.byteSize();
+        m_open = Entry();
+        m_hasOpen = false;
+    }
+}
+
+// ==============================================
+// UNDO / REDO
+// ==============================================
+
+void EditorUndoHistory::apply(const Entry& entry, EditorUndoTarget& target, bool reverse) {
+    size_t count = entry.offsets.size();
+    for (size_t n = 0; n < count; ++n) {
+        size_t index = reverse ? count - 1 - n : n;
+        size_t begin = entry.offsets[index];
+        size_t end = index + 1 < count ? entry.offsets[index + 1] : entry.commands.size();
+
+        ByteReader reader(entry.commands.data() + begin, end - begin);
+        auto type = static_cast<CommandType>(reader.getByte());
+        std::vector<int> ids = readIDSet(reader);
+        if (reader.failed()) {
+            continue;
+        }
+
+        switch (type) {
+        case CommandType::Translate: {
+            float dx = reader.getFloat(), dy = reader.getFloat();
+            if (reverse) target.undoTranslate(ids, -dx, -dy);
+            else target.undoTranslate(ids, dx, dy);
+            break;
+        }
+        case CommandType::Rotate: {
+            float degrees = reader.getFloat();
+            target.undoRotate(ids, reverse ? -degrees : degrees);
+            break;
+        }
+        case CommandType::Property: {
+            auto property = static_cast<UndoProperty>(reader.getVarint());
+            float newValue = reader.getFloat();
+            if (!reverse) {
+                for (int id : ids) target.undoSetProperty(id, property, newValue);
+                break;
+            }
+            uint64_t runCount = reader.getVarint();
+            size_t next = 0;
+            for (uint64_t run = 0; run < runCount && !reader.failed(); ++run) {
+                uint64_t length = reader.getVarint();
+                float oldValue = reader.getFloat();
+                for (uint64_t i = 0; i < length && next < ids.size(); ++i) {
+                    target.undoSetProperty(ids[next++], property, oldValue);
+                }
+            }
+            break;
+        }
+        case CommandType::Create:
+        case CommandType::Remove: {
+            std::string_view objectString = reader.getString();
+            // Undoing a create and redoing a remove both take objects out.
+            if ((type == CommandType::Create) == reverse) target.undoRemove(ids);
+            else target.undoCreate(ids, objectString);
+            break;
+        }
+        case CommandType::Modify: {
+            std::string_view oldObjects = reader.getString();
+            std::string_view newObjects = reader.getString();
+            target.undoModify(ids, reverse ? oldObjects : newObjects);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+bool EditorUndoHistory::undo(EditorUndoTarget& target) {
+    m_groupDepth = 0;
+    closeEntry();
+
+    Entry entry;
+    if (!m_undo.empty()) {
+        entry = std::move(m_undo.back());
+        m_undo.pop_back();
+    } else if (!m_restoredUndo.empty()) {
+        UndoLogRef ref = m_restoredUndo.back();
+        m_restoredUndo.pop_back();
+        m_bytesUsed -= sizeof(UndoLogRef);
+        if (!m_log || !m_log->readEntry(ref, entry)) {
+            // Nothing older can be undone past a step that won't decode.
+            if (m_log) m_log->appendDrop(m_restoredUndo.size() + 1);
+            m_bytesUsed -= m_restoredUndo.size() * sizeof(UndoLogRef);
+            m_restoredUndo.clear();
+            return false;
+        }
+        m_bytesUsed += entry.byteSize();
+    } else {
+        return false;
+    }
+
+    apply(entry, target, true);
+    m_redo.push_back(std::move(entry));
+    if (m_log) m_log->appendUndo();
+    return true;
+}
+
+bool EditorUndoHistory::redo(EditorUndoTarget& target) {
+    m_groupDepth = 0;
+    closeEntry();
+
+    Entry entry;
+    if (!m_redo.empty()) {
+        entry = std::move(m_redo.back());
+        m_redo.pop_back();
+    } else if (!m_restoredRedo.empty()) {
+        UndoLogRef ref = m_restoredRedo.back();
+        m_restoredRedo.pop_back();
+        m_bytesUsed -= sizeof(UndoLogRef);
+        if (!m_log || !m_log->readEntry(ref, entry)) {
+            m_bytesUsed -= m_restoredRedo.size() * sizeof(UndoLogRef);
+            m_restoredRedo.clear();
+            return false;
+        }
+        m_bytesUsed += entry.byteSize();
+    } else {
+        return false;
+    }
+
+    apply(entry, target, false);
+    m_undo.push_back(std::move(entry));
+    if (m_log) m_log->appendRedo();
+    return true;
+}
+
+void EditorUndoHistory::clear() {
+    m_undo.clear();
+    m_redo.clear();
+    m_restoredUndo.clear();
+    m_restoredRedo.clear();
+    m_open = Entry();
+    m_hasOpen = false;
+    m_groupDepth = 0;
+    m_nextDescription.clear();
+    m_bytesUsed = 0;
+    if (m_log) m_log->appendClear();
+}
+
+void EditorUndoHistory::clearRedo() {
+    for (const Entry& entry : m_redo) m_bytesUsed -= entry.byteSize();
+    m_bytesUsed -= m_restoredRedo.size() * sizeof(UndoLogRef);
+    m_redo.clear();
+    m_restoredRedo.clear();
+}
+
+std::string EditorUndoHistory::undoDescription(size_t index) const {
+    if (index < m_undo.size()) return m_undo[m_undo.size() - 1 - index].description;
+    index -= m_undo.size();
+    if (index < m_restoredUndo.size() && m_log) {
+        return m_log->readDescription(m_restoredUndo[m_restoredUndo.size() - 1 - index]);
+    }
+    return std::string();
+}
+
+std::string EditorUndoHistory::redoDescription(size_t index) const {
+    if (index < m_redo.size()) return m_redo[m_redo.size() - 1 - index].description;
+    index -= m_redo.size();
+    if (index < m_restoredRedo.size() && m_log) {
+        return m_log->readDescription(m_restoredRedo[m_restoredRedo.size() - 1 - index]);
+    }
+    return std::string();
+}
+
+// ==============================================
+// LIMITS
+// ==============================================
+
+void EditorUndoHistory::pushUndo(Entry entry) {
+    m_undo.push_back(std::move(entry));
+    if (m_log) m_log->appendPush(m_undo.back());
+    enforceLimits();
+}
+
+void EditorUndoHistory::setByteBudget(size_t bytes) {
+    m_byteBudget = bytes;
+    enforceLimits();
+}
+
+void EditorUndoHistory::setMaxSteps(size_t steps) {
+    m_maxSteps = steps;
+    enforceLimits();
+}
+
+void EditorUndoHistory::enforceLimits() {
+    // The newest step is always kept, even if it alone is over budget.
+    // Restored steps are the oldest, so they go first.
+    size_t dropped = 0;
+    while (undoCount() > 1 &&
+           (m_bytesUsed > m_byteBudget || (m_maxSteps > 0 && undoCount() > m_maxSteps))) {
+        if (!m_restoredUndo.empty()) {
+            m_bytesUsed -= sizeof(UndoLogRef);
+            m_restoredUndo.pop_front();
+        } else {
+            m_bytesUsed -= m_undo.front().byteSize();
+            m_undo.pop_front();
+        }
+        ++dropped;
+    }
+    if (dropped > 0 && m_log) {
+        m_log->appendDrop(dropped);
+    }
+}
+
+// ==============================================
+// PERSISTENCE
+// ==============================================
+
+void EditorUndoHistory::attachLog(EditorUndoLog* log) {
+    detachLog();
+    clear();
+    m_log = log;
+    if (!m_log) {
+        return;
+    }
+
+    m_restoredUndo = log->restoredUndo();
+    m_restoredRedo = log->restoredRedo();
+    m_bytesUsed += (m_restoredUndo.size() + m_restoredRedo.size()) * sizeof(UndoLogRef);
+    enforceLimits();
+}
+
+void EditorUndoHistory::detachLog() {
+    if (!m_log) {
+        return;
+    }
+
+    // Newest first, so a step that won't decode cuts off only older ones.
+    while (!m_restoredUndo.empty()) {
+        Entry entry;
+        bool loaded = m_log->readEntry(m_restoredUndo.back(), entry);
+        m_restoredUndo.pop_back();
+        m_bytesUsed -= sizeof(UndoLogRef);
+        if (!loaded) {
+            m_bytesUsed -= m_restoredUndo.size() * sizeof(UndoLogRef);
+            m_restoredUndo.clear();
+            break;
+        }
+        m_bytesUsed += entry.byteSize();
+        m_undo.push_front(std::move(entry));
+    }
+
+    std::vector<Entry> redo;
+    for (auto it = m_restoredRedo.rbegin(); it != m_restoredRedo.rend(); ++it) {
+        Entry entry;
+        if (!m_log->readEntry(*it, entry)) break;
+        m_bytesUsed += entry.byteSize();
+        redo.push_back(std::move(entry));
+    }
+    m_bytesUsed -= m_restoredRedo.size() * sizeof(UndoLogRef);
+    m_restoredRedo.clear();
+    // redo holds the restored steps next-first; they go below m_redo.
+    std::reverse(redo.begin(), redo.end());
+    m_redo.insert(m_redo.begin(), std::make_move_iterator(redo.begin()), std::make_move_iterator(redo.end()));
+
+    m_log = nullptr;
+    enforceLimits();
+}
+
+// Both stacks fully loaded, in the same order as m_undo / m_redo.
+void EditorUndoHistory::collect(std::vector<Entry>& undo, std::vector<Entry>& redo) const {
+    for (const UndoLogRef& ref : m_restoredUndo) {
+        Entry entry;
+        if (!m_log || !m_log->readEntry(ref, entry)) {
+            undo.clear();  // can't undo past it anyway
+            continue;
+        }
+        undo.push_back(std::move(entry));
+    }
+    undo.insert(undo.end(), m_undo.begin(), m_undo.end());
+
+    for (const UndoLogRef& ref : m_restoredRedo) {
+        Entry entry;
+        if (!m_log || !m_log->readEntry(ref, entry)) {
+            redo.clear();
+            continue;
+        }
+        redo.push_back(std::move(entry));
+    }
+    redo.insert(redo.end(), m_redo.begin(), m_redo.end());
+}
+
+// Undo steps oldest first, then redo steps in the order they'd be redone,
+// then one Undo record per redo step to move those back.
+std::string EditorUndoHistory::serialize() const {
+    std::vector<Entry> undo, redo;
+    collect(undo, redo);
+
+    std::vector<uint8_t> out;
+    EditorUndoLog::writeHeader(out);
+    for (const Entry& entry : undo) EditorUndoLog::writePush(out, entry);
+    if (m_hasOpen && !m_open.offsets.empty()) EditorUndoLog::writePush(out, m_open);
+    for (auto it = redo.rbegin(); it != redo.rend(); ++it) EditorUndoLog::writePush(out, *it);
+    for (size_t i = 0; i < redo.size(); ++i) {
+        EditorUndoLog::writeRecord(out, EditorUndoLog::RecordType::Undo, nullptr, 0);
+    }
+    return std::string(out.begin(), out.end());
+}
+
+bool EditorUndoHistory::deserialize(std::string_view data) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+    EditorUndoLog::Scan scan;
+    if (!EditorUndoLog::scan(bytes, data.size(), scan) || scan.validSize != data.size()) {
+        return false;
+    }
+
+    std::vector<Entry> undo, redo;
+    for (const UndoLogRef& ref : scan.undo) {
+        Entry entry;
+        if (!EditorUndoLog::decodeEntry(bytes, data.size(), ref, entry)) return false;
+        undo.push_back(std::move(entry));
+    }
+    for (const UndoLogRef& ref : scan.redo) {
+        Entry entry;
+        if (!EditorUndoLog::decodeEntry(bytes, data.size(), ref, entry)) return false;
+        redo.push_back(std::move(entry));
+    }
+
+    clear();  // also logged, so an attached log ends up holding the image
+
+    for (Entry& entry : undo) {
+        m_bytesUsed += entry.byteSize();
+        m_undo.push_back(std::move(entry));
+        if (m_log) m_log->appendPush(m_undo.back());
+    }
+    for (auto it = redo.rbegin(); it != redo.rend(); ++it) {
+        if (m_log) m_log->appendPush(*it);
+    }
+    for (Entry& entry : redo) {
+        m_bytesUsed += entry.byteSize();
+        m_redo.push_back(std::move(entry));
+        if (m_log) m_log->appendUndo();
+    }
+    enforceLimits();
+    return true;
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "main.hpp"
+
+#include <deque>
+#include <string_view>
+
+// ==============================================
+// EDITOR UNDO HISTORY
+// ==============================================
+//
+// Undo/redo as reversible commands instead of level snapshots. Each entry
+// (one user action, or one beginGroup/endGroup bracket) is a small byte
+// buffer of commands:
+//
+//   Translate  ids, dx, dy            inverse: -dx, -dy
+//   Rotate     ids, degrees           inverse: -degrees
+//   Property   ids, property, new value, old values (run-length encoded)
+//   Create     ids, object string     inverse: remove ids
+//   Remove     ids, object string     inverse: recreate from the string
+//   Modify     ids, old and new object strings
+//                                     inverse: reapply the old string
+//
+// Scale is a pair of ScaleX/ScaleY property changes: undoing by the factor
+// (1/sx) doesn't give the old value back exactly, and a zero scale has no
+// inverse at all. Modify covers edits a single value can't hold, like group
+// membership. Object strings list the objects in ascending ID order, so
+// object i of the string belongs to ids[i].
+//
+// Object IDs (GameObject unique IDs) are sorted and stored as varint runs
+// of consecutive IDs, so a selection of objects placed together costs a few
+// bytes whatever its size; scattered selections fall back to a bitmap.
+// Inside a group, a command repeating the previous one's kind on the same
+// IDs is folded into it (a drag becomes one translate, a slider one
+// property change).
+//
+// Memory is bounded by bytes (setByteBudget), and optionally by step count;
+// the oldest entries go first.
+//
+// With an EditorUndoLog attached, every change to the stacks is also
+// appended to the log, and steps restored from it stay on disk (as
+// UndoLogRefs below the in-memory ones) until undo/redo reaches them.
+
+// Values are stored, keep them stable.
+enum class UndoProperty : uint16_t {
+    Rotation = 0,
+    ScaleX = 1,
+    ScaleY = 2,
+    Visible = 3,
+    ZOrder = 4,
+    MainColor = 5,    // color channel ID
+    Color = 6,        // tint, packed 0xRRGGBB
+};
+
+// A step kept in an EditorUndoLog's mapping: its Push record payload.
+struct UndoLogRef {
+    uint64_t offset;
+    uint32_t size;
+};
+
+class EditorUndoLog;
+
+// Applies decoded commands to the level (implemented by LevelEditorLayer).
+class EditorUndoTarget {
+public:
+    virtual ~EditorUndoTarget() = default;
+
+    virtual void undoTranslate(const std::vector<int>& ids, float dx, float dy) = 0;
+    virtual void undoRotate(const std::vector<int>& ids, float degrees) = 0;
+    virtual void undoSetProperty(int id, UndoProperty property, float value) = 0;
+    // Recreates objects from their object string; object i gets ids[i] as
+    // its unique ID again.
+    virtual void undoCreate(const std::vector<int>& ids, std::string_view objectString) = 0;
+    virtual void undoRemove(const std::vector<int>& ids) = 0;
+    // Sets the objects' properties to those in the object string.
+    virtual void undoModify(const std::vector<int>& ids, std::string_view objectString) = 0;
+};
+
+class EditorUndoHistory {
+public:
+    static constexpr size_t kDefaultByteBudget = 16 * 1024 * 1024;
+
+    // 3 was Scale (by factor); logs never hold it.
+    enum class CommandType : uint8_t { Translate = 1, Rotate = 2, Property = 4, Create, Remove, Modify };
+
+    // ===== RECORDING (after the change has been applied) =====
+    void recordTranslate(std::vector<int> ids, float dx, float dy);
+    void recordRotate(std::vector<int> ids, float degrees);
+    // oldValues[i] belongs to ids[i].
+    void recordProperty(const std::vector<int>& ids, UndoProperty property,
+                        const std::vector<float>& oldValues, float newValue);
+    void recordCreate(std::vector<int> ids, std::string_view objectString);
+    void recordRemove(std::vector<int> ids, std::string_view objectString);
+    void recordModify(std::vector<int> ids, std::string_view oldObjects, std::string_view newObjects);
+
+    // Everything recorded until the matching endGroup() is one undo step.
+    // Nested groups fold into the outermost one.
+    void beginGroup(std::string_view description);
+    void endGroup();
+    // Reverts what the open group recorded and drops it.
+    void cancelGroup(EditorUndoTarget& target);
+    bool isGroupOpen() const { return m_groupDepth > 0; }
+
+    // Description for the next entry recorded outside a group.
+    void setNextDescription(std::string_view description) { m_nextDescription = description; }
+
+    bool undo(EditorUndoTarget& target);
+    bool redo(EditorUndoTarget& target);
+    void clear();
+
+    size_t undoCount() const { return m_undo.size() + m_restoredUndo.size(); }
+    size_t redoCount() const { return m_redo.size() + m_restoredRedo.size(); }
+    // index 0 = the step undo()/redo() would apply next.
+    std::string undoDescription(size_t index) const;
+    std::string redoDescription(size_t index) const;
+
+    void setByteBudget(size_t bytes);
+    void setMaxSteps(size_t steps);  // 0 = unlimited
+    size_t bytesUsed() const { return m_bytesUsed; }
+
+    // ===== PERSISTENCE =====
+    // Replaces the history with the stacks log restored, and mirrors every
+    // later change into it. log must stay open until detachLog().
+    void attachLog(EditorUndoLog* log);
+    // Loads the steps still only on disk, then stops logging.
+    void detachLog();
+
+    // Whole history in the undo log format; deserialize replaces the
+    // history (and rewrites an attached log to match).
+    std::string serialize() const;
+    bool deserialize(std::string_view data);
+
+    // One undo step.
+    struct Entry {
+        std::string description;
+        std::vector<uint8_t> commands;   // concatenated encoded commands
+        std::vector<uint32_t> offsets;   // start of each command in commands
+
+        size_t byteSize() const {
+            return sizeof(Entry) + description.capacity() + commands.capacity() +
+                   offsets.capacity() * sizeof(uint32_t);
+        }
+    };
+
+private:
+    void appendCommand(CommandType type, const std::vector<int>& sortedIDs,
+                       const std::vector<uint8_t>& payload);
+    Entry& openEntry();
+    void closeEntry();
+    void pushUndo(Entry entry);
+    void enforceLimits();
+    void clearRedo();
+    void apply(const Entry& entry, EditorUndoTarget& target, bool reverse);
+    void collect(std::vector<Entry>& undo, std::vector<Entry>& redo) const;
+
+    std::deque<Entry> m_undo;     // back = most recent
+    std::vector<Entry> m_redo;    // back = next to redo
+    // Below m_undo / m_redo (reached after them); only with a log attached.
+    std::deque<UndoLogRef> m_restoredUndo;
+    std::vector<UndoLogRef> m_restoredRedo;
+    EditorUndoLog* m_log = nullptr;
+    Entry m_open;
+    bool m_hasOpen = false;
+    int m_groupDepth = 0;
+    std::string m_nextDescription;
+
+    // Last command of the open entry, for coalescing.
+    CommandType m_lastType{};
+    size_t m_lastIDsBegin = 0;
+    size_t m_lastIDsEnd = 0;
+
+    size_t m_byteBudget = kDefaultByteBudget;
+    size_t m_maxSteps = 0;
+    size_t m_bytesUsed = 0;
+};
@@ -0,0 +1,400 @@
+// EditorUndoLog.cpp
+#include "EditorUndoLog.hpp"
+#include "ByteStream.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// ==============================================
+// FORMAT
+// ==============================================
+
+void EditorUndoLog::writeHeader(std::vector<uint8_t>& out) {
+    UndoLogHeader header;
+    std::memcpy(header.magic, "GDUL", 4);
+    header.version = kVersion;
+    header.reserved = 0;
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&header);
+    out.insert(out.end(), bytes, bytes + sizeof(header));
+}
+
+void EditorUndoLog::writeRecord(std::vector<uint8_t>& out, RecordType type, const uint8_t* payload,
+                                size_t size) {
+    ByteWriter writer(out);
+    writer.putByte(static_cast<uint8_t>(type));
+    writer.putVarint(size);
+    if (size > 0) writer.putBytes(payload, size);
+}
+
+// Push payload: description, varint command count, varint length of each
+// command, then the command bytes as EditorUndoHistory encoded them.
+void EditorUndoLog::writePush(std::vector<uint8_t>& out, const EditorUndoHistory::Entry& entry) {
+    std::vector<uint8_t> payload;
+    payload.reserve(entry.description.size() + entry.offsets.size() * 2 + entry.commands.size() + 8);
+    ByteWriter writer(payload);
+    writer.putString(entry.description);
+    writer.putVarint(entry.offsets.size());
+    for (size_t i = 0; i < entry.offsets.size(); ++i) {
+        size_t end = i + 1 < entry.offsets.size() ? entry.offsets[i + 1] : entry.commands.size();
+        writer.putVarint(end - entry.offsets[i]);
+    }
+    writer.putBytes(entry.commands.data(), entry.commands.size());
+    writeRecord(out, RecordType::Push, payload.data(), payload.size());
+}
+
+bool EditorUndoLog::scan(const uint8_t* data, size_t size, Scan& out, uint64_t levelStamp) {
+    out = Scan();
+    Scan saved;
+    bool foundSaved = false;
+
+    UndoLogHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, "GDUL", 4) != 0 || header.version != kVersion) {
+        return false;
+    }
+
+    // Only the record headers are read; Push payloads are skipped over, so
+    // their pages aren't touched until a step is actually loaded.
+    ByteReader reader(data + sizeof(header), size - sizeof(header));
+    out.validSize = sizeof(header);
+    while (!reader.atEnd()) {
+        auto type = static_cast<RecordType>(reader.getByte());
+        uint64_t length = reader.getVarint();
+        if (reader.failed() || length > reader.remaining() || length > UINT32_MAX) {
+            break;  // torn or corrupt tail
+        }
+        UndoLogRef ref{static_cast<uint64_t>(reader.position() - data), static_cast<uint32_t>(length)};
+
+        bool valid = true;
+        switch (type) {
+        case RecordType::Push:
+            out.redo.clear();
+            out.undo.push_back(ref);
+            break;
+        case RecordType::Undo:
+            if (out.undo.empty()) { valid = false; break; }
+            out.redo.push_back(out.undo.back());
+            out.undo.pop_back();
+            break;
+        case RecordType::Redo:
+            if (out.redo.empty()) { valid = false; break; }
+            out.undo.push_back(out.redo.back());
+            out.redo.pop_back();
+            break;
+        case RecordType::Drop: {
+            ByteReader count(reader.position(), static_cast<size_t>(length));
+            uint64_t dropped = count.getVarint();
+            if (count.failed()) { valid = false; break; }
+            out.undo.erase(out.undo.begin(), out.undo.begin() + std::min<uint64_t>(dropped, out.undo.size()));
+            break;
+        }
+        case RecordType::Clear:
+            out.undo.clear();
+            out.redo.clear();
+            break;
+        case RecordType::Level: {
+            ByteReader stamp(reader.position(), static_cast<size_t>(length));
+            uint64_t low = stamp.getFixed32();
+            out.levelStamp = low | uint64_t(stamp.getFixed32()) << 32;
+            valid = !stamp.failed();
+            break;
+        }
+        default:
+            valid = false;
+            break;
+        }
+        if (!valid) {
+            break;
+        }
+
+        reader.getBytes(static_cast<size_t>(length));
+        out.validSize = static_cast<size_t>(reader.position() - data);
+        if (levelStamp != 0 && type == RecordType::Level && out.levelStamp == levelStamp) {
+            saved = out;
+            foundSaved = true;
+        }
+    }
+
+    if (levelStamp != 0) {
+        if (!foundSaved) {
+            out = Scan();
+            return false;
+        }
+        out = std::move(saved);
+    }
+    for (const UndoLogRef& ref : out.undo) out.liveBytes += ref.size;
+    for (const UndoLogRef& ref : out.redo) out.liveBytes += ref.size;
+    return true;
+}
+
+bool EditorUndoLog::decodeEntry(const uint8_t* data, size_t size, const UndoLogRef& ref,
+                                EditorUndoHistory::Entry& out) {
+    if (ref.offset > size || ref.size > size - ref.offset) {
+        return false;
+    }
+
+    ByteReader reader(data + ref.offset, ref.size);
+    out = EditorUndoHistory::Entry();
+    out.description = std::string(reader.getString());
+    uint64_t count = reader.getVarint();
+    if (reader.failed() || count > reader.remaining()) {
+        return false;  // every command is at least one byte
+    }
+
+    out.offsets.reserve(static_cast<size_t>(count));
+    uint64_t offset = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        out.offsets.push_back(static_cast<uint32_t>(offset));
+        offset += reader.getVarint();
+    }
+    if (reader.failed() || offset != reader.remaining()) {
+        return false;
+    }
+    std::string_view commands = reader.getBytes(static_cast<size_t>(offset));
+    out.commands.assign(commands.begin(), commands.end());
+    return true;
+}
+
+// ==============================================
+// OPEN / CLOSE
+// ==============================================
+
+bool EditorUndoLog::open(const std::string& path, uint64_t levelStamp) {
+    close();
+    m_path = path;
+
+    // Without a stamp the level's object IDs are new this session and the
+    // log's commands would name the wrong objects.
+    bool valid = levelStamp != 0 && m_file.open(path) &&
+                 scan(m_file.data(), m_file.size(), m_restored, levelStamp);
+    if (valid && m_file.size() >= kCompactMinSize && m_restored.liveBytes * 2 < m_file.size()) {
+        // Mostly records for steps that are gone; rewrite with just the live
+        // ones. On failure the old log is still good to append to.
+        if (compact(m_restored)) {
+            valid = m_file.open(path) && scan(m_file.data(), m_file.size(), m_restored, levelStamp);
+        }
+    }
+    if (!valid) {
+        m_file.close();
+        m_restored = Scan();
+    }
+
+    m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        close();
+        return false;
+    }
+
+    // Start over on an unreadable log, and cut off whatever follows the
+    // saved level's record (a torn append, or steps that were never saved)
+    // so appends continue from there. Restored refs all lie below
+    // validSize, so the mapping never touches the cut-off pages.
+    bool ok;
+    if (valid) {
+        ok = ::ftruncate(m_fd, static_cast<off_t>(m_restored.validSize)) == 0;
+    } else {
+        std::vector<uint8_t> header;
+        writeHeader(header);
+        ok = ::ftruncate(m_fd, 0) == 0 && ::write(m_fd, header.data(), header.size()) == ssize_t(header.size());
+    }
+    if (!ok) {
+        close();
+        return false;
+    }
+
+    m_quit = false;
+    m_failed = false;
+    m_writer = std::thread(&EditorUndoLog::writerMain, this);
+    return true;
+}
+
+void EditorUndoLog::close() {
+    if (m_writer.joinable()) {
+        flush();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_quit = true;
+        }
+        m_wake.notify_one();
+        m_writer.join();
+    }
+    if (m_fd >= 0) {
+        ::fdatasync(m_fd);
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    m_file.close();
+    m_restored = Scan();
+    m_pending.clear();
+}
+
+bool EditorUndoLog::compact(const Scan& live) {
+    std::vector<uint8_t> out;
+    out.reserve(live.liveBytes + (live.undo.size() + live.redo.size()) * 6 + 64);
+    writeHeader(out);
+
+    // Push payloads are copied as they are, without decoding. Redo steps go
+    // in the order they'd be redone, then get undone again.
+    const uint8_t* base = m_file.data();
+    for (const UndoLogRef& ref : live.undo) {
+        writeRecord(out, RecordType::Push, base + ref.offset, ref.size);
+    }
+    for (auto it = live.redo.rbegin(); it != live.redo.rend(); ++it) {
+        writeRecord(out, RecordType::Push, base + it->offset, it->size);
+    }
+    for (size_t i = 0; i < live.redo.size(); ++i) {
+        writeRecord(out, RecordType::Undo, nullptr, 0);
+    }
+    if (live.levelStamp != 0) {
+        std::vector<uint8_t> stamp;
+        ByteWriter writer(stamp);
+        writer.putFixed32(static_cast<uint32_t>(live.levelStamp));
+        writer.putFixed32(static_cast<uint32_t>(live.levelStamp >> 32));
+        writeRecord(out, RecordType::Level, stamp.data(), stamp.size());
+    }
+
+    std::string tempPath = m_path + ".tmp";
+    FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    // Synced before the rename, or a crash could leave the log renamed over
+    // with a file whose data never reached the disk.
+    bool ok = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+    ok = ok && std::fflush(file) == 0 && ::fsync(::fileno(file)) == 0;
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok || std::rename(tempPath.c_str(), m_path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+// ==============================================
+// RESTORED STEPS
+// ==============================================
+
+bool EditorUndoLog::readEntry(const UndoLogRef& ref, EditorUndoHistory::Entry& out) const {
+    return m_file.isOpen() && decodeEntry(m_file.data(), m_file.size(), ref, out);
+}
+
+std::string EditorUndoLog::readDescription(const UndoLogRef& ref) const {
+    if (!m_file.isOpen() || ref.offset > m_file.size() || ref.size > m_file.size() - ref.offset) {
+        return std::string();
+    }
+    ByteReader reader(m_file.data() + ref.offset, ref.size);
+    return std::string(reader.getString());
+}
+
+// ==============================================
+// APPENDING
+// ==============================================
+
+void EditorUndoLog::append(RecordType type, const uint8_t* payload, size_t size) {
+    if (m_fd < 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_failed) {
+            return;
+        }
+        writeRecord(m_pending, type, payload, size);
+    }
+    m_wake.notify_one();
+}
+
+void EditorUndoLog::appendPush(const EditorUndoHistory::Entry& entry) {
+    if (m_fd < 0) {
+        return;
+    }
+    // Encode outside the lock; the writer only ever waits for the append.
+    std::vector<uint8_t> record;
+    writePush(record, entry);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_failed) {
+            return;
+        }
+        m_pending.insert(m_pending.end(), record.begin(), record.end());
+    }
+    m_wake.notify_one();
+}
+
+void EditorUndoLog::appendDrop(size_t count) {
+    std::vector<uint8_t> payload;
+    ByteWriter writer(payload);
+    writer.putVarint(count);
+    append(RecordType::Drop, payload.data(), payload.size());
+}
+
+void EditorUndoLog::appendLevel(uint64_t levelStamp) {
+    std::vector<uint8_t> payload;
+    ByteWriter writer(payload);
+    writer.putFixed32(static_cast<uint32_t>(levelStamp));
+    writer.putFixed32(static_cast<uint32_t>(levelStamp >> 32));
+    append(RecordType::Level, payload.data(), payload.size());
+}
+
+uint64_t EditorUndoLog::levelStampOf(std::string_view data) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (char c : data) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3ull;
+    }
+    return hash != 0 ? hash : 1;  // 0 means "no saved level"
+}
+
+bool EditorUndoLog::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return (!m_busy && m_pending.empty()) || !m_writer.joinable(); });
+    return !m_failed;
+}
+
+void EditorUndoLog::writerMain() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this] { return !m_pending.empty() || m_quit; });
+        if (m_pending.empty()) {
+            return;  // quit, nothing left to write
+        }
+
+        m_writing.swap(m_pending);
+        m_busy = true;
+        lock.unlock();
+
+        bool ok = true;
+        const uint8_t* cursor = m_writing.data();
+        size_t remaining = m_writing.size();
+        while (remaining > 0) {
+            ssize_t written = ::write(m_fd, cursor, remaining);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                ok = false;
+                break;
+            }
+            cursor += written;
+            remaining -= static_cast<size_t>(written);
+        }
+        m_writing.clear();
+
+        lock.lock();
+        if (!ok) {
+            // A partial record is cut off by the next open(); stop appending
+            // after it.
+            m_failed = true;
+            m_pending.clear();
+        }
+        m_busy = false;
+        m_done.notify_all();
+    }
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "main.hpp"
+#include "EditorUndoHistory.hpp"
+#include "MappedFile.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// ==============================================
+// PERSISTENT EDITOR UNDO LOG
+// ==============================================
+//
+// Append-only file next to the level that mirrors EditorUndoHistory, so undo
+// survives closing and reopening the editor. Every change to the stacks is
+// one record:
+//
+//   Push   payload: description, command lengths, command bytes
+//          (a new step; clears redo)
+//   Undo   moves the newest undo step to redo
+//   Redo   moves the next redo step back to undo
+//   Drop   payload: count -- oldest undo steps evicted by the limits
+//   Clear  empties both stacks
+//   Level  payload: 8-byte stamp -- the level was saved here; the stamp
+//          identifies the saved bytes
+//
+// Layout (little-endian):
+//   UndoLogHeader
+//   records: type byte, varint payload length, payload
+//
+// Reopening maps the file and walks the record headers only, skipping the
+// payloads, to rebuild which Push records are still on each stack. A step's
+// commands are decoded when undo/redo first reaches it. A torn last record
+// (crash during an append) ends the walk and is cut off before appending.
+// A log that is mostly dead records is rewritten (temp file + rename) on
+// open.
+//
+// Commands name objects by their editor IDs. Binary level saves keep those
+// IDs, so the log only lines up with the level as saved by one of its Level
+// records: reopening with that stamp rolls the stacks back to that record
+// (later steps were never saved), and a level the log has no record of
+// starts the log over.
+//
+// Appends are encoded on the calling thread into a pending buffer; a writer
+// thread swaps it out and does the write(), so the editor never waits on
+// the disk. flush() is the join point.
+
+#pragma pack(push, 1)
+struct UndoLogHeader {
+    char     magic[4];        // "GDUL"
+    uint16_t version;
+    uint16_t reserved;
+};
+#pragma pack(pop)
+
+class EditorUndoLog {
+public:
+    static constexpr uint16_t kVersion = 2;
+    // Logs smaller than this are never worth compacting.
+    static constexpr size_t kCompactMinSize = 256 * 1024;
+
+    enum class RecordType : uint8_t { Push = 1, Undo, Redo, Drop, Clear, Level };
+
+    EditorUndoLog() = default;
+    ~EditorUndoLog() { close(); }
+
+    EditorUndoLog(const EditorUndoLog&) = delete;
+    EditorUndoLog& operator=(const EditorUndoLog&) = delete;
+
+    // Opens the log at path, creating it if missing, for the level whose
+    // saved bytes have levelStamp (0 if the level didn't come from a binary
+    // save). An unreadable log, or one with no Level record of that stamp,
+    // is started over. False if the file can't be written.
+    bool open(const std::string& path, uint64_t levelStamp);
+    // Writes out pending appends and unmaps the file. Steps restored from the
+    // mapping must have been loaded or dropped first (see
+    // EditorUndoHistory::detachLog).
+    void close();
+    bool isOpen() const { return m_fd >= 0; }
+
+    // The stacks as the log left them when it was opened; undo front = oldest,
+    // redo back = next to redo.
+    const std::deque<UndoLogRef>& restoredUndo() const { return m_restored.undo; }
+    const std::vector<UndoLogRef>& restoredRedo() const { return m_restored.redo; }
+
+    // Decodes a restored step from the mapping. False if it is corrupt.
+    bool readEntry(const UndoLogRef& ref, EditorUndoHistory::Entry& out) const;
+    std::string readDescription(const UndoLogRef& ref) const;
+
+    void appendPush(const EditorUndoHistory::Entry& entry);
+    void appendUndo() { append(RecordType::Undo, nullptr, 0); }
+    void appendRedo() { append(RecordType::Redo, nullptr, 0); }
+    void appendDrop(size_t count);
+    void appendClear() { append(RecordType::Clear, nullptr, 0); }
+    void appendLevel(uint64_t levelStamp);
+
+    // Stamp of a saved level: FNV-1a of its bytes.
+    static uint64_t levelStampOf(std::string_view data);
+
+    // Blocks until everything appended so far has been written. False once a
+    // write has failed; later appends are then discarded.
+    bool flush();
+
+    // ===== FORMAT (shared with EditorUndoHistory::serialize) =====
+
+    struct Scan {
+        std::deque<UndoLogRef> undo;
+        std::vector<UndoLogRef> redo;
+        size_t validSize = 0;     // header + every complete record
+        size_t liveBytes = 0;     // payloads still on a stack
+        uint64_t levelStamp = 0;  // last Level record, 0 if none
+    };
+
+    static void writeHeader(std::vector<uint8_t>& out);
+    static void writeRecord(std::vector<uint8_t>& out, RecordType type, const uint8_t* payload, size_t size);
+    static void writePush(std::vector<uint8_t>& out, const EditorUndoHistory::Entry& entry);
+    // False if data doesn't start with a valid header; a bad record just
+    // ends the scan. With a nonzero levelStamp, out is the log as of the
+    // last Level record with that stamp, and false if there is none.
+    static bool scan(const uint8_t* data, size_t size, Scan& out, uint64_t levelStamp = 0);
+    static bool decodeEntry(const uint8_t* data, size_t size, const UndoLogRef& ref,
+                            EditorUndoHistory::Entry& out);
+
+private:
+    void append(RecordType type, const uint8_t* payload, size_t size);
+    bool compact(const Scan& live);
+    void writerMain();
+
+    std::string m_path;
+    MappedFile m_file;
+    Scan m_restored;
+    int m_fd = -1;
+
+    std::thread m_writer;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::vector<uint8_t> m_pending;   // appended, not yet handed to the writer
+    std::vector<uint8_t> m_writing;   // owned by the writer while m_busy
+    bool m_busy = false;
+    bool m_quit = false;
+    bool m_failed = false;
+};
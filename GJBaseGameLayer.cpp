@@ -5,9 +5,33 @@
 #include "GameManager.h"
 #include "GameObject.h"
 #include "PlayerObject.h"
+#include "CollisionBroadPhase.hpp"
+#include "SlopeSolver.hpp"
+#include "PlayerParticleManager.hpp"
+#include "PlayerCollisionLog.hpp"
+#include "PlayerUpdateWorker.hpp"
+#include "PlayerIconCache.hpp"
+#include "PlayerReplay.hpp"
+#include "InputLatency.hpp"
+#include "EditorObjectRecord.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string_view>
 
 class GJBaseGameLayer {
 public:
+    ~GJBaseGameLayer() {
+        // The manager outlives the layer; it must not keep the batch nodes
+        // (or a pointer) in a layer that is going away.
+        PlayerParticleManager* particles = PlayerParticleManager::sharedManager();
+        if (particles->layer() == m_gameLayer) {
+            particles->detachFromLayer();
+        }
+        destroyLevelObjects();
+    }
+
     void createPlayer() {
         // Stack protection
         long stackGuard = __stack_chk_guard;
@@ -16,11 +40,15 @@ public:
 
         // Get player icon IDs from GameManager
         GameManager* gm = GameManager::sharedState();
+        PlayerIconCache* icons = PlayerIconCache::sharedCache();
 
         // Calculate player cube icon ID
         int cubeID = gm->playerCube - gm->playerCubeUnlocked;  // 0x264 - 0x268
         int shipID = gm->playerShip - gm->playerShipUnlocked;  // 0x270 - 0x274
 
+        // Player emitters are batched just below the players (z 59)
+        PlayerParticleManager::sharedManager()->attachToLayer(m_gameLayer, 58);
+
         // Create player object
         // Parameters: cubeID, shipID, this, gameLayer, isPlayer2?
         PlayerObject* player1 = PlayerObject::create(cubeID, shipID, this,
@@ -32,22 +60,23 @@ public:
 
         // Get primary color (cube color)
         int primaryColorID = gm->primaryColor - gm->primaryColorUnlocked;  // 0x2c4 - 0x2c8
-        ccColor3B primaryColor = GameManager::colorForIdx(primaryColorID);
+        ccColor3B primaryColor = icons->colorForIdx(primaryColorID);
 
         // Set player color
         player1->setColor(primaryColor);
 
         // Get secondary color (ship trail)
         int secondaryColorID = gm->secondaryColor - gm->secondaryColorUnlocked;  // 0x2d0 - 0x2d4
-        ccColor3B secondaryColor = GameManager::colorForIdx(secondaryColorID);
+        ccColor3B secondaryColor = icons->colorForIdx(secondaryColorID);
 
         // Set secondary color
         player1->setSecondColor(secondaryColor);
 
         // Get glow color if enabled
         int glowColorID = gm->glowColor - gm->glowColorUnlocked;  // 0x2dc - 0x2e0
+        ccColor3B glowColor = {};
         if (glowColorID >= 0) {
-            ccColor3B glowColor = GameManager::colorForIdx(glowColorID);
+            glowColor = icons->colorForIdx(glowColorID);
             player1->enableCustomGlowColor(glowColor);
         }
 
@@ -81,10 +110,8 @@ public:
 
         // Only create player2 if in dual mode
         if (m_isDualMode) {
-            // Calculate player icon IDs again (may have changed)
-            cubeID = gm->playerCube - gm->playerCubeUnlocked;
-            shipID = gm->playerShip - gm->playerShipUnlocked;
-
+            // Same icons as player 1; the sheets are already resident in
+            // PlayerIconCache, so this only takes another reference.
             // Create player2
             PlayerObject* player2 = PlayerObject::create(cubeID, shipID, this,
                                                         m_gameLayer, true);  // isPlayer2 = true
@@ -93,19 +120,12 @@ public:
 
             // ===== SET PLAYER 2 COLORS =====
 
-            // Player2 uses secondary color as primary
-            int player2PrimaryColorID = gm->secondaryColor - gm->secondaryColorUnlocked;
-            ccColor3B player2PrimaryColor = GameManager::colorForIdx(player2PrimaryColorID);
-            player2->setColor(player2PrimaryColor);
-
-            // Player2 uses primary color as secondary
-            int player2SecondaryColorID = gm->primaryColor - gm->primaryColorUnlocked;
-            ccColor3B player2SecondaryColor = GameManager::colorForIdx(player2SecondaryColorID);
-            player2->setSecondColor(player2SecondaryColor);
+            // Player2 swaps player 1's primary and secondary colors
+            player2->setColor(secondaryColor);
+            player2->setSecondColor(primaryColor);
 
             // Glow color (same as player1)
             if (glowColorID >= 0) {
-                ccColor3B glowColor = GameManager::colorForIdx(glowColorID);
                 player2->enableCustomGlowColor(glowColor);
             }
 
@@ -133,6 +153,304 @@ public:
         }
     }
 
+    // ===== LEVEL RESTART =====
+
+    // Restart keeps the players built by createPlayer and puts them back in
+    // place with PlayerObject::reset: sprites, icon sheets, glow and pooled
+    // emitters all survive. Only a mode mismatch (dual mode needs a player 2
+    // that was never built) goes through a full rebuild.
+    void resetPlayers(const cocos2d::CCPoint& startPosition) {
+        auto begin = std::chrono::steady_clock::now();
+        bool rebuilt = false;
+
+        if (!m_player1 || (m_isDualMode && !m_player2)) {
+            removePlayers();
+            createPlayer();
+            // New players have empty collision logs and no solver
+            setupPlayerForLevel(m_player1);
+            setupPlayerForLevel(m_player2);
+            if (m_isPlayingReplay) {
+                attachReplay(&m_replayPlayer);
+            }
+            rebuilt = true;
+        } else {
+            char playerProp = m_isDualMode ? m_dualPlayerProperty : 0;
+
+            m_player1->reset(startPosition);
+            m_player1->updateCheckpointMode(GameManager::getGameVariable("0068"));
+            m_player1->toggleMode(!m_isDualMode);
+            m_player1->m_unknownC34 = playerProp;
+
+            if (m_player2) {
+                m_player2->reset(startPosition);
+                m_player2->toggleMode(false);
+                m_player2->m_unknownC34 = playerProp;
+                m_player2->setVisible(m_isDualMode);
+            }
+        }
+        m_hasLastPlayerRects = false;
+
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        RestartTiming& timing = rebuilt ? m_rebuildTiming : m_resetTiming;
+        timing.lastMs = ms;
+        timing.totalMs += ms;
+        timing.worstMs = std::max(timing.worstMs, ms);
+        ++timing.count;
+    }
+
+    // "reset 0.08ms avg / 0.31ms worst (n=42), rebuild 6.90ms avg (n=1)"
+    std::string restartTimingSummary() const {
+        char buffer[160];
+        std::snprintf(buffer, sizeof(buffer),
+                      "reset %.2fms avg / %.2fms worst (n=%u), rebuild %.2fms avg / %.2fms worst (n=%u)",
+                      m_resetTiming.averageMs(), m_resetTiming.worstMs, m_resetTiming.count,
+                      m_rebuildTiming.averageMs(), m_rebuildTiming.worstMs, m_rebuildTiming.count);
+        return buffer;
+    }
+
+    // ===== REPLAYS =====
+
+    // Plays a .gdr file back through both players: each substep gets the
+    // inputs recorded on it (PlayerObject::setReplayPlayer). A restart
+    // plays it again from the start.
+    bool playReplay(const std::string& path) {
+        if (!m_replayPlayer.load(path)) {
+            return false;
+        }
+        m_isPlayingReplay = true;
+        attachReplay(&m_replayPlayer);
+        return true;
+    }
+
+    void stopReplay() {
+        m_isPlayingReplay = false;
+        attachReplay(nullptr);
+    }
+
+    // ===== PLAYER PARTICLES =====
+
+    // Once per frame, after the camera has moved.
+    void updatePlayerParticles(const cocos2d::CCRect& visibleRect) {
+        PlayerParticleManager::sharedManager()->update(visibleRect);
+    }
+
+    // Low detail mode stops simulating player emitters that are off-screen.
+    void setPlayerParticlesLowDetail(bool lowDetail) {
+        PlayerParticleManager::sharedManager()->setLowDetailMode(lowDetail);
+    }
+
+    // ===== LEVEL OBJECTS =====
+
+    // Level load: one GameObject per object of the level string, added to
+    // the game layer. Particle strings (key 145) are carved from the level
+    // arena, and the array becomes m_levelObjects through
+    // buildCollisionBroadPhase, so level exit can use destroyLevelObjects.
+    // A malformed object ends the parse; what came before it still loads.
+    void createObjectsFromSetup(const std::string& levelString) {
+        destroyLevelObjects();
+
+        std::vector<EditorObjectRecord> records;
+        parseObjectStrings(levelString, records);
+
+        ObjectBufferArena* arena = objectBufferArena();
+        cocos2d::CCArray* objects = cocos2d::CCArray::createWithCapacity(static_cast<unsigned int>(records.size()));
+        for (const EditorObjectRecord& record : records) {
+            GameObject* obj = GameObject::createWithKey(record.objectID);
+            if (!obj) continue;
+
+            obj->setPosition(cocos2d::CCPoint(record.x, record.y));
+            obj->setRotation(record.rotation);
+            obj->setScaleX(record.scaleX);
+            obj->setScaleY(record.scaleY);
+            obj->setVisible(!record.hidden);
+            for (int i = 0; i < record.groupCount; ++i) {
+                obj->addToGroup(record.groups[i]);
+            }
+            std::string_view particle = extraValue(record.extra, "145");
+            if (!particle.empty()) {
+                obj->setParticleString(particle.data(), particle.size(), arena);
+            }
+
+            m_gameLayer->addChild(obj, record.zOrder);
+            objects->addObject(obj);
+        }
+
+        buildCollisionBroadPhase(objects);
+    }
+
+    // Object setup carves long particle strings from this while the level
+    // loads (GameObject::setParticleString).
+    ObjectBufferArena* objectBufferArena() {
+        if (!m_objectBufferArena) {
+            m_objectBufferArena = ObjectBufferArena::create();
+        }
+        return m_objectBufferArena;
+    }
+
+    // Level exit: drops the level's objects and the arena their particle
+    // strings came from (GameObject::destroyObjects).
+    void destroyLevelObjects() {
+        m_collisionObjects.clear();
+        m_collisionBroadPhase.clear();
+        m_slopeSolver.clear();
+        m_hasLastPlayerRects = false;
+
+        if (m_levelObjects) {
+            GameObject::destroyObjects(m_levelObjects, m_objectBufferArena);
+            m_levelObjects->release();
+            m_levelObjects = nullptr;
+        } else if (m_objectBufferArena) {
+            m_objectBufferArena->release();
+        }
+        m_objectBufferArena = nullptr;
+    }
+
+    // ===== COLLISION BROAD-PHASE =====
+
+    // Called once after the level's objects are created. Only objects that
+    // can collide with the player go into the section grid.
+    void buildCollisionBroadPhase(cocos2d::CCArray* objects) {
+        // This is the level's object list; keep it for destroyLevelObjects.
+        if (objects != m_levelObjects) {
+            if (objects) objects->retain();
+            if (m_levelObjects) m_levelObjects->release();
+            m_levelObjects = objects;
+        }
+
+        m_collisionObjects.clear();
+        m_slopeSolver.clear();
+        std::vector<BroadPhaseRect> bounds;
+
+        unsigned int count = objects ? objects->count() : 0;
+        m_collisionObjects.reserve(count);
+        bounds.reserve(count);
+
+        for (unsigned int i = 0; i < count; ++i) {
+            auto* obj = static_cast<GameObject*>(objects->objectAtIndex(i));
+            if (!obj) continue;
+            if (obj->isDecoration()) {
+                obj->m_collisionIndex = -1;
+                continue;
+            }
+
+            cocos2d::CCRect rect = obj->getObjectRect();
+            obj->m_collisionIndex = static_cast<int>(m_collisionObjects.size());
+            if (obj->isSlope()) {
+                m_slopeSolver.addSlope(obj->m_collisionIndex, rect.origin.x, rect.origin.y,
+                                       rect.size.width, rect.size.height,
+                                       obj->isFlipX(), obj->isFlipY());
+            }
+            m_collisionObjects.push_back(obj);
+            bounds.push_back(BroadPhaseRect::fromOriginSize(rect.origin.x, rect.origin.y,
+                                                            rect.size.width, rect.size.height));
+        }
+
+        m_slopeSolver.link();
+        m_collisionBroadPhase.build(bounds);
+        m_hasLastPlayerRects = false;
+
+        setupPlayerForLevel(m_player1);
+        setupPlayerForLevel(m_player2);
+    }
+
+    // Ties a player to the current level's collision data: the log is sized
+    // once here so ticks never allocate, and the slope chain starts over
+    // (indices from an old solver mean nothing in this one). Called for
+    // every player the level has, whether it existed at load or was rebuilt
+    // by resetPlayers.
+    void setupPlayerForLevel(PlayerObject* player) {
+        if (!player) return;
+        player->m_collisionLog.resize(m_collisionObjects.size());
+        player->m_slopeSolver = &m_slopeSolver;
+        player->m_currentSlope = -1;
+    }
+
+    // Every path that moves, rotates or scales a level object must end here
+    // (moveLevelObject does), since player collisions read the broad-phase's
+    // copy of the bounds rather than the live rect.
+    void updateCollisionObject(GameObject* obj) {
+        int index = obj->m_collisionIndex;  // slot assigned by buildCollisionBroadPhase
+        if (index < 0 || index >= static_cast<int>(m_collisionObjects.size())) return;
+
+        cocos2d::CCRect rect = obj->getObjectRect();
+        m_collisionBroadPhase.updateBounds(index, BroadPhaseRect::fromOriginSize(
+            rect.origin.x, rect.origin.y, rect.size.width, rect.size.height));
+        if (obj->isSlope()) {
+            m_slopeSolver.updateSlope(index, rect.origin.x, rect.origin.y,
+                                      rect.size.width, rect.size.height,
+                                      obj->isFlipX(), obj->isFlipY());
+        }
+    }
+
+    // ===== PLAYER UPDATE =====
+
+    // Per frame: physics + collisions for every player. In dual mode player 2
+    // is stepped on m_playerWorker while player 1 runs here. Until the join
+    // each player only writes its own state (stepper, collision log, node
+    // position) and only reads level data that nothing mutates mid-frame, so
+    // the result does not depend on which thread ran first. Everything that
+    // touches shared state (orbs, triggers, deaths) waits for the join and is
+    // applied player 1 then player 2, exactly like the serial order.
+    void updatePlayers(float dt) {
+        if (!m_player1) return;
+
+        bool dual = m_isDualMode && m_player2;
+        // Replay recorders and checksum writers are shared between players
+        bool parallel = dual && m_parallelPlayerUpdate && PlayerUpdateWorker::isSupported() &&
+                        !m_player1->needsSerialUpdate() && !m_player2->needsSerialUpdate();
+
+        // One frame time for both players, so their input cut-offs match
+        uint64_t timestampNs = inputTimestampNow();
+        m_playerStepDelta = dt;
+        m_playerStepTimestamp = timestampNs;
+        if (parallel) {
+            m_playerWorker.dispatch(&GJBaseGameLayer::stepPlayer2Task, this);
+            stepPlayer(m_player1, m_lastPlayerRect1, m_collisionCandidates1, m_queryContext1, dt, timestampNs);
+            m_playerWorker.wait();
+        } else {
+            stepPlayer(m_player1, m_lastPlayerRect1, m_collisionCandidates1, m_queryContext1, dt, timestampNs);
+            if (dual) {
+                stepPlayer(m_player2, m_lastPlayerRect2, m_collisionCandidates2, m_queryContext2, dt, timestampNs);
+            }
+        }
+        m_hasLastPlayerRects = true;
+
+        // ---- join point ----
+        applyPlayerContacts(m_player1);
+        if (dual) {
+            applyPlayerContacts(m_player2);
+        }
+    }
+
+    // The per-frame level step, for PlayLayer and the editor's playtest:
+    // players first, then settling objects that stopped moving (no query is
+    // in flight after the join point), then particles.
+    void updateLevel(float dt) {
+        updatePlayers(dt);
+        m_collisionBroadPhase.advanceFrame();
+        updatePlayerParticles(visibleLevelRect());
+    }
+
+    // The part of the game layer that is on screen, in level coordinates.
+    cocos2d::CCRect visibleLevelRect() const {
+        cocos2d::CCSize winSize = cocos2d::CCDirector::sharedDirector()->getWinSize();
+        if (!m_gameLayer || m_gameLayer->getScale() <= 0.0f) {
+            return cocos2d::CCRect(0.0f, 0.0f, winSize.width, winSize.height);
+        }
+        float scale = m_gameLayer->getScale();
+        cocos2d::CCPoint origin = m_gameLayer->getPosition();
+        return cocos2d::CCRect(-origin.x / scale, -origin.y / scale,
+                               winSize.width / scale, winSize.height / scale);
+    }
+
+    // Debug / settings toggle; the serial path is always available.
+    void setParallelPlayerUpdate(bool enabled) {
+        m_parallelPlayerUpdate = enabled;
+        if (!enabled) {
+            m_playerWorker.stop();
+        }
+    }
+
     void processAreaMoveGroupAction(cocos2d::CCArray* objects, 
                                    EnterEffectInstance* effect,
                                    const cocos2d::CCPoint& target,
@@ -353,19 +671,7 @@ process_object:
                         updateObjectToCurrentGroup(obj, currentGroup);
                     }
                     
-                    // Apply vertical force
-                    if (finalForceY != 0.0f) {
-                        obj->addYPosition(finalForceY);
-                    }
-                    
-                    // Mark object as dirty
-                    obj->dirtifyObjectPos();
-                    obj->dirtifyObjectRect();
-                    
-                    // Apply horizontal force (if object allows it)
-                    if (finalForceX != 0.0f && !obj->isXMovementLocked()) {
-                        obj->addXPosition(finalForceX);
-                    }
+                    moveLevelObject(obj, finalForceX, finalForceY);
                     
                     // Trigger object callback
                     triggerObjectAction(obj);
@@ -422,7 +728,13 @@ process_object:
                     float finalForceX = finalDirection * movementDirection.x;
                     float finalForceY = finalDirection * movementDirection.y;
                     
-                    // ... similar application logic
+                    if (finalForceX != 0.0f || finalForceY != 0.0f) {
+                        if (objGroup < currentGroup) {
+                            updateObjectToCurrentGroup(obj, currentGroup);
+                        }
+                        moveLevelObject(obj, finalForceX, finalForceY);
+                        triggerObjectAction(obj);
+                    }
                 }
             }
             
@@ -446,6 +758,114 @@ private:
         return m_forceMultipliers[groupIndex + multiplierIndex];  // +0x10e4
     }
     
+    void attachReplay(ReplayPlayer* replay) {
+        if (m_player1) m_player1->setReplayPlayer(replay);
+        if (m_player2) m_player2->setReplayPlayer(replay);
+    }
+
+    void removePlayers() {
+        if (m_player1) {
+            m_player1->removeFromParentAndCleanup(true);
+            m_player1 = nullptr;
+        }
+        if (m_player2) {
+            m_player2->removeFromParentAndCleanup(true);
+            m_player2->release();  // retained in createPlayer
+            m_player2 = nullptr;
+        }
+    }
+
+    // Value of `key` in an EditorObjectRecord::extra (",key,value,..."),
+    // empty when the key isn't there.
+    static std::string_view extraValue(std::string_view extra, std::string_view key) {
+        while (!extra.empty()) {
+            size_t keyEnd = extra.find(',', 1);
+            if (keyEnd == std::string_view::npos) break;
+            size_t valueEnd = extra.find(',', keyEnd + 1);
+            std::string_view value = extra.substr(keyEnd + 1, valueEnd == std::string_view::npos
+                                                                  ? std::string_view::npos
+                                                                  : valueEnd - keyEnd - 1);
+            if (extra.substr(1, keyEnd - 1) == key) return value;
+            if (valueEnd == std::string_view::npos) break;
+            extra = extra.substr(valueEnd);
+        }
+        return {};
+    }
+
+    BroadPhaseRect playerBroadPhaseRect(PlayerObject* player) {
+        cocos2d::CCRect rect = player->getObjectRect();
+        return BroadPhaseRect::fromOriginSize(rect.origin.x, rect.origin.y,
+                                              rect.size.width, rect.size.height);
+    }
+
+    // Only reads the broad-phase's copy of the object bounds, not
+    // GameObject::getObjectRect (which refreshes a cached rect), so two
+    // players can resolve against the same objects at once. Moved objects
+    // are current as long as they went through updateCollisionObject.
+    void resolvePlayerCollisions(PlayerObject* player, float dt, const std::vector<uint32_t>& candidates) {
+        BroadPhaseRect playerRect = playerBroadPhaseRect(player);
+        for (uint32_t index : candidates) {
+            GameObject* obj = m_collisionObjects[index];
+            const BroadPhaseRect& bounds = m_collisionBroadPhase.bounds(index);
+            if (!playerRect.intersects(bounds)) continue;
+
+            if (obj->isSlope()) {
+                player->preSlopeCollision(dt, obj);
+            }
+            cocos2d::CCRect objRect(bounds.minX, bounds.minY,
+                                    bounds.maxX - bounds.minX, bounds.maxY - bounds.minY);
+            player->collidedWithObject(dt, obj, objRect, landsOnTop(playerRect, bounds));
+        }
+    }
+
+    // Player-local half of a frame; safe to run for both players at once.
+    void stepPlayer(PlayerObject* player, BroadPhaseRect& lastRect, std::vector<uint32_t>& candidates,
+                    BroadPhaseQueryContext& queryContext, float dt, uint64_t timestampNs) {
+        player->resetCollisionLog();
+        player->updatePhysics(dt, timestampNs);
+
+        BroadPhaseRect current = playerBroadPhaseRect(player);
+        BroadPhaseRect swept = m_hasLastPlayerRects ? BroadPhaseRect::swept(lastRect, current) : current;
+        m_collisionBroadPhase.query(swept, candidates, queryContext);
+        resolvePlayerCollisions(player, dt, candidates);
+        lastRect = current;
+    }
+
+    static void stepPlayer2Task(void* context) {
+        auto* layer = static_cast<GJBaseGameLayer*>(context);
+        layer->stepPlayer(layer->m_player2, layer->m_lastPlayerRect2, layer->m_collisionCandidates2,
+                          layer->m_queryContext2, layer->m_playerStepDelta, layer->m_playerStepTimestamp);
+    }
+
+    // Join-point half: contacts whose effects reach outside the player.
+    void applyPlayerContacts(PlayerObject* player) {
+        player->m_collisionLog.forEach(CollisionContactKind::Touch, [&](const CollisionContact& contact) {
+            if (contact.objectIndex >= m_collisionObjects.size()) return;
+            GameObject* obj = m_collisionObjects[contact.objectIndex];
+            if (obj->m_objectType == 1810) { // Ring
+                player->ringJump(obj);
+            }
+        });
+    }
+
+    // Trigger displacement of one object; keeps its collision bounds current.
+    void moveLevelObject(GameObject* obj, float dx, float dy) {
+        // Apply vertical force
+        if (dy != 0.0f) {
+            obj->addYPosition(dy);
+        }
+
+        // Mark object as dirty
+        obj->dirtifyObjectPos();
+        obj->dirtifyObjectRect();
+
+        // Apply horizontal force (if object allows it)
+        if (dx != 0.0f && !obj->isXMovementLocked()) {
+            obj->addXPosition(dx);
+        }
+        updateCollisionObject(obj);
+    }
+
     void updateObjectToCurrentGroup(GameObject* obj, int currentGroup) {
         // Update object group and save previous state
         if (!obj->isGroupFrozen()) {  // +0x4fa
@@ -482,4 +902,42 @@ private:
     int m_totalProcessed;          // +0x3614
     int m_currentGroup;            // +0x3c8
     float m_forceMultipliers[32];  // +0x10e4 - array of force multipliers
+
+    // Level objects and the arena their buffers come from (not part of the
+    // original layout)
+    cocos2d::CCArray* m_levelObjects = nullptr;
+    ObjectBufferArena* m_objectBufferArena = nullptr;
+
+    // Collision broad-phase (not part of the original layout)
+    CollisionBroadPhase m_collisionBroadPhase;
+    SlopeSolver m_slopeSolver;
+    std::vector<GameObject*> m_collisionObjects;
+    std::vector<uint32_t> m_collisionCandidates1;
+    std::vector<uint32_t> m_collisionCandidates2;
+    BroadPhaseRect m_lastPlayerRect1;
+    BroadPhaseRect m_lastPlayerRect2;
+    bool m_hasLastPlayerRects = false;
+
+    // Dual mode parallel update (see updatePlayers)
+    PlayerUpdateWorker m_playerWorker;
+    BroadPhaseQueryContext m_queryContext1;
+    BroadPhaseQueryContext m_queryContext2;
+    float m_playerStepDelta = 0.0f;
+    uint64_t m_playerStepTimestamp = 0;
+    bool m_parallelPlayerUpdate = true;
+
+    // Replay playback (see playReplay)
+    ReplayPlayer m_replayPlayer;
+    bool m_isPlayingReplay = false;
+
+    // Level restart timing (see resetPlayers)
+    struct RestartTiming {
+        double lastMs = 0.0;
+        double totalMs = 0.0;
+        double worstMs = 0.0;
+        uint32_t count = 0;
+        double averageMs() const { return count ? totalMs / count : 0.0; }
+    };
+    RestartTiming m_resetTiming;
+    RestartTiming m_rebuildTiming;
 };
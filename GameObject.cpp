@@ -116,29 +116,54 @@ GameObject::~GameObject() {
         m_secondarySprite = nullptr;
     }
 
-    uintptr_t globalSentinel = *(uintptr_t*)((uintptr_t)cocos2d::CCDirector::sharedDirector() + 0xfe8);
-
-    if (m_particleString && (uintptr_t(m_particleString) - 0x18) != globalSentinel) {
-        delete[] m_particleString;
+    // m_particleString*/m_particleData* are OwnedString/OwnedBuffer handles and
+    // free themselves after this body; only the physics object is still raw.
+    // Arena handles never touch arena memory when they go, so the arena
+    // reference can be dropped first.
+    if (m_bufferArena) {
+        m_bufferArena->release();
+        m_bufferArena = nullptr;
     }
-    if (m_particleString2 && (uintptr_t(m_particleString2) - 0x18) != globalSentinel) {
-        delete[] m_particleString2;
+    // The sentinel is only read when there is something to free.
+    if (m_physicsObject) {
+        uintptr_t globalSentinel = *(uintptr_t*)((uintptr_t)cocos2d::CCDirector::sharedDirector() + 0xfe8);
+        if ((uintptr_t(m_physicsObject) - 0x18) != globalSentinel) {
+            delete[] reinterpret_cast<char*>(uintptr_t(m_physicsObject) - 0x18);
+        }
+        m_physicsObject = nullptr;
     }
+}
 
-    if (m_particleData) delete[] m_particleData;
-    if (m_particleData2) delete[] m_particleData2;
-    if (m_particleData3) delete[] m_particleData3;
+void GameObject::setParticleString(const char* str, size_t length, ObjectBufferArena* arena) {
+    if (arena && length > OwnedString::kInlineCapacity) {
+        if (m_bufferArena != arena) {
+            arena->retain();
+            if (m_bufferArena) m_bufferArena->release();
+            m_bufferArena = arena;
+        }
+        m_particleString.assign(str, length, *arena);
+    } else {
+        m_particleString.assign(str, length);
+    }
+}
 
-    if (m_physicsObject && (uintptr_t(m_physicsObject) - 0x18) != globalSentinel) {
-        delete[] reinterpret_cast<char*>(uintptr_t(m_physicsObject) - 0x18);
+void GameObject::destroyObjects(cocos2d::CCArray* objects, ObjectBufferArena* arena) {
+    // Objects go in array order, each through its own ~GameObject. Releasing
+    // one field across all objects per pass measured 2-3x slower
+    // (bench/LevelTeardownBench.cpp): objects and their sprites are
+    // allocated together at load, so freeing them together is what the
+    // allocator handles best. The saving is the particle strings, which
+    // live in the arena instead of one heap block each. Objects retained
+    // elsewhere (a trigger's target list) simply survive the array.
+    if (objects) {
+        objects->removeAllObjects();
     }
 
-    m_particleString = m_particleString2 = nullptr;
-    m_particleData = m_particleData2 = m_particleData3 = nullptr;
-    m_physicsObject = nullptr;
+    // The blocks go now unless an object still alive holds a reference.
+    if (arena) {
+        arena->release();
+    }
 }
 
-GameObject::GameObject() {
-    // Zero-initialize all members
-    memset(reinterpret_cast<uint8_t*>(this) + 0x34, 0, sizeof(GameObject) - 0x34);
-}
+// Members are initialised in the class; the handles start Empty.
+GameObject::GameObject() = default;
@@ -3,6 +3,7 @@
 #include <cocos2d.h>
 #include "CCSpritePlus.h"
 #include "GameManager.h"
+#include "OwnedBuffer.hpp"
 
 extern int g_nextObjectID; // DAT_012fe018
 
@@ -18,28 +19,46 @@ class TextGameObject;
 class GameObject : public cocos2d::CCNode {
 protected:
     // Verified offsets from disassembly
-    cocos2d::CCSprite* m_secondarySprite;   // 0x2e0
-    cocos2d::CCSprite* m_mainSprite;        // 0x2f0
-    void*              m_physicsObject;     // 0x310
-    int                m_objectID;          // 0x34
-    cocos2d::CCSprite* m_colorSprite;       // 0x368
-    int                m_uniqueID;          // 0x384
-    bool               m_hasGlow;           // 0x289
-    bool               m_highDetail;        // 0x420
-    bool               m_dontFade;          // 0x4fe
-    int                m_objectType;        // 0x3f4
-
-    // Particle system data
-    char* m_particleString;   // 0x438
-    char* m_particleString2;  // 0x440
-    int*  m_particleData;     // 0x478
-    int*  m_particleData2;    // 0x488
-    int*  m_particleData3;    // 0x498
+    cocos2d::CCSprite* m_secondarySprite = nullptr;   // 0x2e0
+    cocos2d::CCSprite* m_mainSprite = nullptr;        // 0x2f0
+    void*              m_physicsObject = nullptr;     // 0x310
+    int                m_objectID = 0;                // 0x34
+    cocos2d::CCSprite* m_colorSprite = nullptr;       // 0x368
+    int                m_uniqueID = 0;                // 0x384
+    bool               m_hasGlow = false;             // 0x289
+    bool               m_highDetail = false;          // 0x420
+    bool               m_dontFade = false;            // 0x4fe
+    int                m_objectType = 0;              // 0x3f4
+
+    // Particle system data (owned handles, see OwnedBuffer.hpp). Each handle
+    // is 0x18 bytes where the binary had an 8-byte char*/int*, so this block
+    // is laid out contiguously from 0x438 and runs to 0x4b0; the original
+    // pointers sat at 0x438/0x440/0x478/0x488/0x498. Offsets of GameObject
+    // members past 0x438 no longer match the shipped binary.
+    OwnedString      m_particleString;   // 0x438 (was char* 0x438)
+    OwnedString      m_particleString2;  // 0x450 (was char* 0x440)
+    OwnedBuffer<int> m_particleData;     // 0x468 (was int* 0x478)
+    OwnedBuffer<int> m_particleData2;    // 0x480 (was int* 0x488)
+    OwnedBuffer<int> m_particleData3;    // 0x498 (was int* 0x498)
+    ObjectBufferArena* m_bufferArena = nullptr;  // retained while any handle is Arena
+
+    // Collision classification, filled in by object setup from the object's
+    // type (not part of the original layout).
+    bool m_isDecoration = false;
+    bool m_isSlope = false;
 
 public:
+    // Slot in GJBaseGameLayer's collision broad-phase, -1 for objects that
+    // can't collide (not part of the original layout).
+    int m_collisionIndex = -1;
+
     GameObject();
     virtual ~GameObject();
 
+    // Decoration never reaches the broad-phase; slopes also go to SlopeSolver.
+    bool isDecoration() const { return m_isDecoration; }
+    bool isSlope() const { return m_isSlope; }
+
     static void resetMID();
     void assignUniqueID();
 
@@ -53,6 +72,16 @@ public:
     static cocos2d::CCSpriteFrame* getGlowFrame(const std::string& baseFrame);
 
     bool shouldHaveGlow() const;
+
+    // Level load: long strings are carved from the level's arena (when
+    // given) instead of one heap block per object.
+    void setParticleString(const char* str, size_t length, ObjectBufferArena* arena = nullptr);
+
+    // Level teardown: empties the array, then drops the caller's reference
+    // to the level arena. Objects still retained by something other than
+    // the array keep their own arena reference, so nothing they hold is
+    // freed under them.
+    static void destroyObjects(cocos2d::CCArray* objects, ObjectBufferArena* arena = nullptr);
 };
 
 // EnhancedGameObject.hpp
@@ -65,7 +94,7 @@ public:
 // TextGameObject.hpp
 class TextGameObject : public GameObject {
 private:
-    char* m_textContent; // 0x538
+    OwnedString m_textContent; // was char* 0x538; follows the wider GameObject
 public:
     TextGameObject();
     virtual ~TextGameObject();
@@ -182,31 +211,19 @@ GameObject::~GameObject() {
     if (m_colorSprite) { m_colorSprite->release(); m_colorSprite = nullptr; }
     if (m_secondarySprite) { m_secondarySprite->release(); m_secondarySprite = nullptr; }
 
-    // Global sentinel pointer (PTR_DAT_012fdfe8 == *(CCDirector + 0xfe8))
-    uintptr_t globalSentinel = *(uintptr_t*)((uintptr_t)cocos2d::CCDirector::sharedDirector() + 0xfe8);
-
-    // Particle strings
-    if (m_particleString && (uintptr_t(m_particleString) - 0x18) != globalSentinel) {
-        delete[] m_particleString;
-    }
-    if (m_particleString2 && (uintptr_t(m_particleString2) - 0x18) != globalSentinel) {
-        delete[] m_particleString2;
-    }
-
-    // Particle arrays (always owned)
-    if (m_particleData) delete[] m_particleData;
-    if (m_particleData2) delete[] m_particleData2;
-    if (m_particleData3) delete[] m_particleData3;
+    // Particle strings/arrays are released by their OwnedString/OwnedBuffer
+    // handles; Arena ones live as long as the arena reference dropped here.
+    if (m_bufferArena) { m_bufferArena->release(); m_bufferArena = nullptr; }
 
     // Physics object
-    if (m_physicsObject && (uintptr_t(m_physicsObject) - 0x18) != globalSentinel) {
-        delete[] reinterpret_cast<char*>(uintptr_t(m_physicsObject) - 0x18);
+    if (m_physicsObject) {
+        // Global sentinel pointer (PTR_DAT_012fdfe8 == *(CCDirector + 0xfe8))
+        uintptr_t globalSentinel = *(uintptr_t*)((uintptr_t)cocos2d::CCDirector::sharedDirector() + 0xfe8);
+        if ((uintptr_t(m_physicsObject) - 0x18) != globalSentinel) {
+            delete[] reinterpret_cast<char*>(uintptr_t(m_physicsObject) - 0x18);
+        }
+        m_physicsObject = nullptr;
     }
-
-    // Nullify
-    m_particleString = m_particleString2 = nullptr;
-    m_particleData = m_particleData2 = m_particleData3 = nullptr;
-    m_physicsObject = nullptr;
 }
 
 // EnhancedGameObject.cpp
@@ -214,11 +231,5 @@ EnhancedGameObject::EnhancedGameObject() = default;
 EnhancedGameObject::~EnhancedGameObject() = default;
 
 // TextGameObject.cpp
-TextGameObject::TextGameObject() : m_textContent(nullptr) {}
-TextGameObject::~TextGameObject() {
-    uintptr_t globalSentinel = *(uintptr_t*)((uintptr_t)cocos2d::CCDirector::sharedDirector() + 0xfe8);
-    if (m_textContent && (uintptr_t(m_textContent) - 0x18) != globalSentinel) {
-        delete[] reinterpret_cast<char*>(uintptr_t(m_textContent) - 0x18);
-    }
-    m_textContent = nullptr;
-}
+TextGameObject::TextGameObject() = default;
+TextGameObject::~TextGameObject() = default; // m_textContent frees itself
@@ -0,0 +1,321 @@
+// HeadlessLevelSimulator.cpp
+#include "HeadlessLevelSimulator.hpp"
+#include "PlayerReplay.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+namespace {
+
+struct ObjectShape {
+    HeadlessObjectKind kind;
+    float width, height;
+};
+
+// Object ID -> collision shape, for the objects that can decide a run.
+// Hitbox sizes follow the in-game values (spikes are much smaller than the
+// 30x30 cell they are drawn in).
+bool shapeForObjectID(int objectID, ObjectShape& out) {
+    switch (objectID) {
+        case 1: case 2: case 3: case 4: case 5: case 6: case 7:
+        case 83: case 69: case 70: case 71: case 72: case 73: case 74:
+            out = {HeadlessObjectKind::Solid, 30.0f, 30.0f};
+            return true;
+        case 40: case 62: case 63: case 64: case 65: case 66: case 68:
+            out = {HeadlessObjectKind::Solid, 30.0f, 14.0f}; // slabs
+            return true;
+        case 8: case 144: case 177:
+            out = {HeadlessObjectKind::Hazard, 6.0f, 12.0f};  // spike
+            return true;
+        case 39: case 205:
+            out = {HeadlessObjectKind::Hazard, 6.0f, 5.6f};   // small spike
+            return true;
+        case 103:
+            out = {HeadlessObjectKind::Hazard, 4.0f, 7.6f};   // medium spike
+            return true;
+        case 88: case 89: case 98:
+            out = {HeadlessObjectKind::Hazard, 21.6f, 21.6f}; // saws (square approximation)
+            return true;
+        case 35:
+            out = {HeadlessObjectKind::JumpPad, 25.0f, 4.0f};
+            return true;
+        case 36:
+            out = {HeadlessObjectKind::JumpOrb, 36.0f, 36.0f};
+            return true;
+        case 289:
+            out = {HeadlessObjectKind::Slope, 30.0f, 30.0f};
+            return true;
+        case 291:
+            out = {HeadlessObjectKind::Slope, 60.0f, 30.0f};  // wide slope
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Contacts use BroadPhaseRect::intersects, which counts touching edges (a
+// player standing on a block touches it); deaths need real overlap, so
+// running under a block with exactly the player's height of room is safe.
+bool overlapsStrictly(const BroadPhaseRect& a, const BroadPhaseRect& b) {
+    return a.minX < b.maxX && a.maxX > b.minX && a.minY < b.maxY && a.maxY > b.minY;
+}
+
+BroadPhaseRect playerRect(const PlayerPhysicsState& state) {
+    return BroadPhaseRect::fromOriginSize(state.x, state.y, HeadlessLevelSimulator::kPlayerSize,
+                                          HeadlessLevelSimulator::kPlayerSize);
+}
+
+} // namespace
+
+// ==============================================
+// LEVEL LOADING
+// ==============================================
+
+HeadlessLevel HeadlessLevel::fromObjectString(int levelID, const std::string& objectString) {
+    HeadlessLevel level;
+    level.levelID = levelID;
+
+    float maxX = 0.0f;
+    size_t start = 0;
+    while (start < objectString.size()) {
+        size_t end = objectString.find(';', start);
+        if (end == std::string::npos) end = objectString.size();
+
+        // Walk "key,value,key,value,..." pairs of one object.
+        int objectID = 0;
+        float x = 0.0f, y = 0.0f;
+        bool flipX = false, flipY = false;
+        size_t cursor = start;
+        while (cursor < end) {
+            size_t keyEnd = objectString.find(',', cursor);
+            if (keyEnd == std::string::npos || keyEnd >= end) break;
+            size_t valueEnd = objectString.find(',', keyEnd + 1);
+            if (valueEnd == std::string::npos || valueEnd > end) valueEnd = end;
+
+            const char* value = objectString.c_str() + keyEnd + 1;
+            if (keyEnd - cursor == 1) {
+                switch (objectString[cursor]) {
+                    case '1': objectID = std::atoi(value); break;
+                    case '2': x = std::strtof(value, nullptr); break;
+                    case '3': y = std::strtof(value, nullptr); break;
+                    case '4': flipX = std::atoi(value) != 0; break;
+                    case '5': flipY = std::atoi(value) != 0; break;
+                    default: break;
+                }
+            }
+            cursor = valueEnd + 1;
+        }
+
+        ObjectShape shape;
+        if (objectID > 0 && shapeForObjectID(objectID, shape)) {
+            // Object strings store centres; the runner works with corners.
+            level.objects.push_back({x - shape.width * 0.5f, y - shape.height * 0.5f,
+                                     shape.width, shape.height, shape.kind, flipX, flipY});
+        }
+        if (objectID > 0) {
+            maxX = std::max(maxX, x);
+        }
+
+        start = end + 1;
+    }
+
+    std::sort(level.objects.begin(), level.objects.end(),
+              [](const HeadlessObject& a, const HeadlessObject& b) { return a.x < b.x; });
+
+    // Same load-time build as GJBaseGameLayer::buildCollisionBroadPhase.
+    std::vector<BroadPhaseRect> bounds;
+    bounds.reserve(level.objects.size());
+    for (size_t i = 0; i < level.objects.size(); ++i) {
+        const HeadlessObject& obj = level.objects[i];
+        if (obj.kind == HeadlessObjectKind::Slope) {
+            level.slopes.addSlope(static_cast<uint32_t>(i), obj.x, obj.y, obj.width, obj.height,
+                                  obj.flipX, obj.flipY);
+        }
+        bounds.push_back(BroadPhaseRect::fromOriginSize(obj.x, obj.y, obj.width, obj.height));
+    }
+    level.slopes.link();
+    level.broadPhase.build(bounds);
+
+    level.length = maxX + 90.0f; // three cells past the last object
+    return level;
+}
+
+// ==============================================
+// SINGLE RUN
+// ==============================================
+
+HeadlessRunResult HeadlessLevelSimulator::run(const HeadlessLevel& level,
+                                              const std::vector<HeadlessInputEvent>& inputs,
+                                              uint32_t maxTicks,
+                                              ReplayChecksumWriter* checksums) const {
+    auto startTime = std::chrono::steady_clock::now();
+
+    HeadlessRunResult result;
+    result.levelID = level.levelID;
+
+    PlayerPhysicsState initial;
+    initial.xVelocity = kNormalSpeed;
+    PlayerPhysicsStepper stepper(initial);
+    if (checksums) {
+        stepper.setTickObserver(&ReplayChecksumWriter::onStepperTick, checksums);
+    }
+
+    const std::vector<HeadlessObject>& objects = level.objects;
+    BroadPhaseQueryContext queryContext;
+    std::vector<uint32_t> candidates;
+    BroadPhaseRect lastRect = playerRect(stepper.state());
+    int32_t currentSlope = -1;
+    size_t nextInput = 0;
+    uint32_t lastOrb = UINT32_MAX;
+    uint64_t hash = 0xcbf29ce484222325ull;
+
+    while (stepper.tick() < maxTicks) {
+        uint32_t tick = stepper.tick();
+
+        // ===== INPUT =====
+        // What PlayerObject::pushButton/releaseButton do with the jump button.
+        while (nextInput < inputs.size() && inputs[nextInput].tick <= tick) {
+            if (inputs[nextInput].player == 0) {
+                stepper.setJumpHeld(inputs[nextInput].pressed);
+            }
+            ++nextInput;
+        }
+
+        // ===== PHYSICS =====
+        stepper.step();
+
+        // ===== COLLISION =====
+        PlayerPhysicsState& state = stepper.state();
+        BroadPhaseRect current = playerRect(state);
+        level.broadPhase.query(BroadPhaseRect::swept(lastRect, current), candidates, queryContext);
+        lastRect = current;
+
+        bool dead = false;
+        bool supported = state.onGround && state.y <= state.floorY;
+        for (uint32_t index : candidates) {
+            const HeadlessObject& obj = objects[index];
+            const BroadPhaseRect& bounds = level.broadPhase.bounds(index);
+            if (!current.intersects(bounds)) {
+                continue;
+            }
+
+            switch (obj.kind) {
+                case HeadlessObjectKind::Solid:
+                    if (landsOnTop(current, bounds)) {
+                        state.y = bounds.maxY;
+                        state.yVelocity = 0.0f;
+                        state.onGround = true;
+                        state.isFlying = false;
+                        supported = true;
+                    } else if (overlapsStrictly(current, bounds)) {
+                        dead = true;
+                    }
+                    break;
+                case HeadlessObjectKind::Slope: {
+                    float surface;
+                    if (level.slopes.contactHeightFor(index, currentSlope, current.minX, current.maxX, surface) &&
+                        level.slopes.slope(currentSlope).surfaceOnTop && state.yVelocity <= 0.0f &&
+                        state.y <= surface && state.y >= surface - kLandingTolerance) {
+                        state.y = surface;
+                        state.yVelocity = 0.0f;
+                        state.onGround = true;
+                        state.isFlying = false;
+                        supported = true;
+                    }
+                    break;
+                }
+                case HeadlessObjectKind::Hazard:
+                    if (overlapsStrictly(current, bounds)) {
+                        dead = true;
+                    }
+                    break;
+                case HeadlessObjectKind::JumpPad:
+                    if (state.yVelocity < kPadVelocity * 0.5f) {
+                        stepper.setYVelocity(kPadVelocity);
+                    }
+                    break;
+                case HeadlessObjectKind::JumpOrb:
+                    // PlayerObject::ringJump's rule
+                    if (stepper.jumpHeld() && lastOrb != index) {
+                        stepper.setYVelocity(PlayerPhysicsStepper::kOrbVelocity * static_cast<float>(state.gravityDir));
+                        lastOrb = index;
+                    }
+                    break;
+            }
+            if (dead) break;
+        }
+
+        // Walked off a ledge
+        if (!supported && state.onGround && state.y > state.floorY) {
+            state.onGround = false;
+        }
+
+        hash = hashPlayerState(state, hash);
+
+        // deathTick uses the same numbering as HeadlessInputEvent::tick: the
+        // substep that started at `tick`, not the counter after it.
+        if (dead) {
+            result.outcome = HeadlessRunOutcome::Died;
+            result.deathTick = tick;
+            break;
+        }
+        if (state.x >= level.length) {
+            result.outcome = HeadlessRunOutcome::Completed;
+            break;
+        }
+    }
+
+    result.stateHash = hash;
+    result.ticks = stepper.tick();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    result.ticksPerSecond = seconds > 0.0 ? result.ticks / seconds : 0.0;
+    return result;
+}
+
+// ==============================================
+// PARALLEL BATCH
+// ==============================================
+
+std::vector<HeadlessRunResult> HeadlessLevelSimulator::runBatch(
+        const std::vector<HeadlessLevel>& levels,
+        const std::vector<std::vector<HeadlessInputEvent>>& inputs,
+        unsigned int threadCount,
+        uint32_t maxTicks) const {
+    std::vector<HeadlessRunResult> results(levels.size());
+    if (levels.empty()) {
+        return results;
+    }
+
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = std::min<unsigned int>(threadCount, static_cast<unsigned int>(levels.size()));
+
+    static const std::vector<HeadlessInputEvent> kNoInput;
+    std::atomic<size_t> nextLevel{0};
+
+    // Each worker pulls the next unclaimed level; runs share nothing but
+    // the read-only level/input data, so results are thread-count independent.
+    auto worker = [&]() {
+        for (size_t index = nextLevel++; index < levels.size(); index = nextLevel++) {
+            const auto& levelInputs = index < inputs.size() ? inputs[index] : kNoInput;
+            results[index] = run(levels[index], levelInputs, maxTicks);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (unsigned int i = 1; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return results;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "main.hpp"
+#include "PlayerPhysicsStepper.hpp"
+#include "CollisionBroadPhase.hpp"
+#include "SlopeSolver.hpp"
+
+class ReplayChecksumWriter;
+
+// ==============================================
+// HEADLESS LEVEL SIMULATION
+// ==============================================
+//
+// Batch validation runner: loads a level's object string, feeds a recorded
+// input stream and steps the game without cocos2d. GJBaseGameLayer,
+// PlayerObject and GJEffectManager all need a running CCDirector and build
+// sprites, glow and particles as a side effect, so the runner keeps only
+// what decides the outcome of a run, built from the same cocos-free parts
+// the game uses:
+//   - PlayerPhysicsStepper, with input through setJumpHeld like
+//     PlayerObject::pushButton/releaseButton (hold-to-jump, orb velocity)
+//   - CollisionBroadPhase over the level's collision boxes, queried with the
+//     swept player box as GJBaseGameLayer::stepPlayer does
+//   - landsOnTop for solids and SlopeSolver::contactHeightFor for slopes
+// Levels are independent, so a batch is spread over worker threads.
+//
+// What the game does not model yet stays here: deaths (side hits on solids,
+// hazards), pads, and the object ID -> hitbox table. Triggers and game modes
+// other than the cube are not simulated.
+
+enum class HeadlessObjectKind : uint8_t {
+    Solid,      // blocks: land on top, die on side/bottom hits
+    Hazard,     // spikes and saws: die on touch
+    JumpPad,    // yellow pad: forced bounce
+    JumpOrb,    // yellow orb: bounce while the button is held
+    Slope,      // land on the surface, no side hits
+};
+
+struct HeadlessObject {
+    float x, y;          // bottom-left corner in level space
+    float width, height;
+    HeadlessObjectKind kind;
+    bool flipX = false;
+    bool flipY = false;
+};
+
+struct HeadlessInputEvent {
+    uint32_t tick;
+    uint8_t  player;     // 0 or 1
+    bool     pressed;
+};
+
+struct HeadlessLevel {
+    int levelID = 0;
+    float length = 0.0f;                  // x at which the level counts as complete
+    std::vector<HeadlessObject> objects;  // sorted by x after load
+    CollisionBroadPhase broadPhase;       // over objects, same indices
+    SlopeSolver slopes;                   // the Slope objects, by object index
+
+    // Parses GD's "1,<id>,2,<x>,3,<y>,4,<flip x>,5,<flip y>;..." object
+    // string. Object IDs the runner does not know are decoration and are
+    // dropped.
+    static HeadlessLevel fromObjectString(int levelID, const std::string& objectString);
+};
+
+enum class HeadlessRunOutcome : uint8_t {
+    Completed,  // reached HeadlessLevel::length
+    Died,
+    TimedOut,   // still alive after maxTicks
+};
+
+struct HeadlessRunResult {
+    int      levelID = 0;
+    HeadlessRunOutcome outcome = HeadlessRunOutcome::TimedOut;
+    uint64_t stateHash = 0;       // chained hashPlayerState over every tick
+    int64_t  deathTick = -1;      // input tick of the fatal substep; -1 unless Died
+    uint32_t ticks = 0;
+    double   ticksPerSecond = 0.0;
+};
+
+class HeadlessLevelSimulator {
+public:
+    static constexpr float kPlayerSize = 30.0f;
+    static constexpr float kNormalSpeed = 311.58f / 60.0f; // 1x speed, units per 1/60 s
+    static constexpr float kPadVelocity = 16.0f;
+
+    // maxTicks bounds runs whose input keeps the player alive forever.
+    // checksums, if given, receives the state after every substep's
+    // integrate, the same point PlayerObject::setChecksumWriter records.
+    HeadlessRunResult run(const HeadlessLevel& level,
+                          const std::vector<HeadlessInputEvent>& inputs,
+                          uint32_t maxTicks = 240 * 60 * 10,
+                          ReplayChecksumWriter* checksums = nullptr) const;
+
+    // Runs level i with inputs[i] on up to threadCount workers
+    // (0 = hardware concurrency). Results are in level order.
+    std::vector<HeadlessRunResult> runBatch(const std::vector<HeadlessLevel>& levels,
+                                            const std::vector<std::vector<HeadlessInputEvent>>& inputs,
+                                            unsigned int threadCount = 0,
+                                            uint32_t maxTicks = 240 * 60 * 10) const;
+};
@@ -0,0 +1,55 @@
+// InputLatency.cpp
+#include "InputLatency.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+uint64_t inputTimestampNow() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void InputLatencyTracker::record(uint64_t latencyNs) {
+    uint64_t bucket = latencyNs / (kBucketMicros * 1000ull);
+    if (bucket >= kBucketCount) {
+        bucket = kBucketCount - 1;
+    }
+    ++m_buckets[bucket];
+    ++m_samples;
+    m_maxNs = std::max(m_maxNs, latencyNs);
+}
+
+void InputLatencyTracker::reset() {
+    std::memset(m_buckets, 0, sizeof(m_buckets));
+    m_samples = 0;
+    m_maxNs = 0;
+}
+
+double InputLatencyTracker::percentileMs(double percentile) const {
+    if (m_samples == 0) {
+        return 0.0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(m_samples));
+    if (target >= m_samples) target = m_samples - 1;
+
+    uint64_t seen = 0;
+    for (uint32_t bucket = 0; bucket < kBucketCount; ++bucket) {
+        seen += m_buckets[bucket];
+        if (seen > target) {
+            // Report the bucket's upper edge (conservative)
+            return (bucket + 1) * kBucketMicros / 1000.0;
+        }
+    }
+    return maxMs();
+}
+
+std::string InputLatencyTracker::summary() const {
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), "p50 %.1fms p95 %.1fms p99 %.1fms max %.1fms (n=%llu)",
+                  percentileMs(50.0), percentileMs(95.0), percentileMs(99.0), maxMs(),
+                  static_cast<unsigned long long>(m_samples));
+    return buffer;
+}
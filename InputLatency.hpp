@@ -0,0 +1,47 @@
+#pragma once
+
+#include "main.hpp"
+
+// ==============================================
+// INPUT TIMESTAMPS & LATENCY INSTRUMENTATION
+// ==============================================
+//
+// Input events carry the steady-clock time they were captured at (ideally
+// the JNI touch/key callback, before cocos2d queues the event for the next
+// frame). PlayerPhysicsStepper uses the timestamp to apply the input at the
+// substep it actually happened in, and reports how long the input waited
+// before the physics consumed it to an InputLatencyTracker.
+
+// Monotonic nanoseconds, same clock for capture and frame timing.
+uint64_t inputTimestampNow();
+
+struct TimedInput {
+    uint64_t timestampNs;
+    uint8_t  button;     // PlayerButton value
+    bool     pressed;
+};
+
+// Fixed-size latency histogram: 100 us buckets up to 250 ms, everything
+// slower lands in the last bucket. Recording is a single increment.
+class InputLatencyTracker {
+public:
+    static constexpr uint32_t kBucketMicros = 100;
+    static constexpr uint32_t kBucketCount = 2500;
+
+    void record(uint64_t latencyNs);
+    void reset();
+
+    uint64_t sampleCount() const { return m_samples; }
+
+    // Latency in milliseconds at percentile (0-100), bucket resolution.
+    double percentileMs(double percentile) const;
+    double maxMs() const { return m_maxNs / 1e6; }
+
+    // "p50 1.2ms p95 4.8ms p99 9.1ms max 16.0ms (n=1234)"
+    std::string summary() const;
+
+private:
+    uint32_t m_buckets[kBucketCount] = {};
+    uint64_t m_samples = 0;
+    uint64_t m_maxNs = 0;
+};
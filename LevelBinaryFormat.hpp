@@ -0,0 +1,71 @@
+#pragma once
+
+#include "main.hpp"
+#include "EditorObjectRecord.hpp"
+
+#include <string_view>
+
+// ==============================================
+// BINARY LEVEL FORMAT
+// ==============================================
+//
+// Columnar encoding of a level's objects. Parsing the text object string
+// means float parsing plus key lookups for every property of every object;
+// here each property is one column of varints, and neighbouring objects
+// (placed together, same type, same groups) mostly differ by small deltas.
+//
+//   integers   object ID, z order, colors and the flattened group list:
+//              zigzag varint of the delta from the previous object
+//   floats     x, y, rotation, scale: fixed point in 1/kFixedScale units,
+//              delta-encoded like the integers. A value that isn't an exact
+//              multiple of that step is listed as an exception with its raw
+//              bits, so every float reads back bit for bit.
+//   hidden     bitmap
+//   extra      unmodelled key,value text per object, length-prefixed
+//   unique ID  the editor's object IDs, delta-encoded like the integers, so
+//              the undo log still names the right objects after a reload
+//   level header  the text format's "kS38,..." segment, verbatim
+//
+// Columns are framed as (varint column ID, varint length, bytes). Readers
+// skip IDs they don't know and default the optional columns that are
+// absent, so a column can be added without a version bump; kVersion only
+// changes when an existing column's encoding does.
+//
+// Layout (little-endian):
+//   LevelBinaryHeader
+//   body                          column frames, zlib-compressed if
+//                                 kFlagCompressed is set
+//
+// The text object string stays the interchange format (exports, the
+// clipboard, other tools); binary is for the editor's own saves and copies.
+
+#pragma pack(push, 1)
+struct LevelBinaryHeader {
+    char     magic[4];        // "GDLB"
+    uint16_t version;
+    uint8_t  flags;
+    uint8_t  reserved;
+    uint32_t objectCount;
+    uint32_t bodySize;        // uncompressed
+};
+#pragma pack(pop)
+
+class LevelBinaryFormat {
+public:
+    static constexpr uint16_t kVersion = 1;
+    static constexpr uint8_t kFlagCompressed = 1;
+    static constexpr int kFixedScale = 64;
+
+    // True if data starts with a binary level header (anything else is
+    // treated as an object string).
+    static bool isBinary(std::string_view data);
+
+    // Replaces out. Compression trades encode time for roughly a third of
+    // the size.
+    static bool write(const std::vector<EditorObjectRecord>& objects, bool compress, std::string& out,
+                      std::string_view levelHeader = {});
+    // Appends to out; false on a bad header or corrupt body, with out left
+    // as it was. levelHeader, if given, is replaced (empty if none was saved).
+    static bool read(std::string_view data, std::vector<EditorObjectRecord>& out,
+                     std::string* levelHeader = nullptr);
+};
@@ -12,7 +12,6 @@
 #include "GameObject.h"
 #include "LevelSettingsObject.h"
 #include "SongObject.h"
-#include "UndoManager.h"
 #include "SelectionManager.h"
 #include "GridManager.h"
 #include "SnapManager.h"
@@ -32,14 +31,26 @@
 #include "MultiplayerEditorManager.h"
 #include "CloudSaveManager.h"
 #include "BackupManager.h"
+#include "EditorSpatialIndex.hpp"
+#include "EditorSelectionQueries.hpp"
+#include "EditorUndoHistory.hpp"
+#include "EditorUndoLog.hpp"
+#include "EditorAutoSave.hpp"
+#include "LevelBinaryFormat.hpp"
+#include "MappedFile.hpp"
 
+#include <algorithm>
+#include <cstdio>
 #include <queue>
 #include <stack>
 #include <functional>
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <future>
+#include <unordered_map>
 
 // Object types (from GameObject.h)
 enum GameObjectType {
@@ -104,6 +115,13 @@ enum SelectionMode {
     SELECT_SHRINK = 8
 };
 
+// Level data formats (serializeLevel)
+enum LevelDataFormat {
+    LEVEL_FORMAT_TEXT = 0,                // object string, what the game and other tools read
+    LEVEL_FORMAT_BINARY = 1,              // LevelBinaryFormat
+    LEVEL_FORMAT_BINARY_COMPRESSED = 2
+};
+
 class LevelEditorLayer : public GJBaseGameLayer,
                          public DrawGridLayer,      // Multiple inheritance
                          public EditorUI,
@@ -111,7 +129,8 @@ class LevelEditorLayer : public GJBaseGameLayer,
                          public cocos2d::CCTouchDelegate,
                          public cocos2d::CCKeypadDelegate,
                          public cocos2d::CCMouseDelegate,
-                         public cocos2d::CCAccelerometerDelegate {
+                         public cocos2d::CCAccelerometerDelegate,
+                         public EditorUndoTarget {
 public:
     // ========== CREATION & INITIALIZATION ==========
     
@@ -257,7 +276,11 @@ public:
     
     // ========== OBJECT CREATION ==========
     
+    // Every object enters and leaves the level through these, which keep
+    // the spatial index current and record undo.
     GameObject* createObject(int objectID, cocos2d::CCPoint position);
+    void removeObject(GameObject* obj);
+    void deleteSelectedObjects();  // one undo step
     GameObject* createObjectAtCursor();
     GameObject* createObjectWithProperties(const std::string& json);
     
@@ -393,6 +416,30 @@ public:
     std::string getUndoDescription(int index) const;
     std::string getRedoDescription(int index) const;
     
+    // Undo memory is bounded in bytes (oldest steps dropped first);
+    // setMaxUndoSteps is an extra cap on top, 0 = none.
+    void setUndoMemoryLimit(size_t bytes);
+    size_t getUndoMemoryUsage() const;
+    
+    // Keeps undo in "<level path>.undo" across sessions. Opening replaces the
+    // history with the one the log holds (steps are read from disk as undo
+    // reaches them); closing loads those steps and writes out what's pending.
+    // Open it after deserializeLevel: the log is only restored for the exact
+    // binary save it last saw (see EditorUndoLog), anything else starts it
+    // over. Text saves never match: they don't keep the unique IDs every
+    // undo step refers to, so a level with an undo log is saved through
+    // saveLevel, which writes binary.
+    bool openUndoLog(const std::string& levelPath);
+    void closeUndoLog();
+    
+    // EditorUndoTarget: replays undo commands without recording them again.
+    void undoTranslate(const std::vector<int>& ids, float dx, float dy) override;
+    void undoRotate(const std::vector<int>& ids, float degrees) override;
+    void undoSetProperty(int id, UndoProperty property, float value) override;
+    void undoCreate(const std::vector<int>& ids, std::string_view objectString) override;
+    void undoRemove(const std::vector<int>& ids) override;
+    void undoModify(const std::vector<int>& ids, std::string_view objectString) override;
+    
     // ========== COPY/PASTE/CUT ==========
     
     void copySelected();
@@ -408,6 +455,7 @@ public:
     void pasteFromJSON(const std::string& json);
     void copyAsXML();
     void pasteFromXML(const std::string& xml);
+    // Binary copies go to m_binaryClipboard; pasting selects the new objects.
     void copyAsBinary();
     void pasteFromBinary(const std::string& data);
     
@@ -437,6 +485,9 @@ public:
     
     // ========== SAVING/LOADING ==========
     
+    // The editor's own save file. loadLevel reads either format and opens
+    // the level's undo log; saveLevel always writes binary, the only format
+    // the undo log survives a reopen through (see openUndoLog).
     void saveLevel();
     void saveAs();
     void saveCopy();
@@ -448,9 +499,16 @@ public:
     void loadFromCloud(const std::string& cloudID);
     void loadFromURL(const std::string& url);
     
+    // Autosave is incremental: a pass snapshots only the objects changed
+    // since the previous one, and the autosave thread (m_autoSaveThread)
+    // encodes, compresses and writes them. autoSave() starts a pass now;
+    // enableAutoSave starts one every `interval` seconds.
     void autoSave();
     void restoreAutoSave();
     void enableAutoSave(bool enabled, float interval = 60.0f);
+    void setAutoSavePath(const std::string& path);
+    // Longest time a pass has held the editor thread, in milliseconds.
+    float getAutoSaveWorstStall() const;
     
     void exportLevel(const std::string& format); // JSON, XML, Binary, Image
     void importLevel(const std::string& filepath, const std::string& format);
@@ -660,6 +718,7 @@ public:
     
     void updateEditor(float dt);
     void updateSelection(float dt);
+    void updateAutoSave(float dt);  // from updateEditor
     void updateUI(float dt);
     void updateCamera(float dt);
     void updatePlaytest(float dt);
@@ -707,9 +766,26 @@ public:
     float getDistanceToObject(GameObject* obj, cocos2d::CCPoint point);
     float getAngleToObject(GameObject* obj, cocos2d::CCPoint point);
     
+    // Spatial index upkeep. Every object in m_objectContainer must be indexed
+    // for the queries above to see it. onEnter rebuilds the index over the
+    // loaded level, createObject/removeObject index and unindex, and the
+    // transform setters refresh bounds; code that adds or removes children
+    // of m_objectContainer any other way calls indexObject/unindexObject.
+    void rebuildSpatialIndex();
+    void indexObject(GameObject* obj);
+    void unindexObject(GameObject* obj);
+    void refreshObjectBounds(GameObject* obj);
+    
     // ========== SERIALIZATION ==========
     
-    std::string serializeLevel();
+    // deserializeLevel takes either format (binary is told apart by its
+    // header) and replaces every object in the level, closing the undo log.
+    // Text is the default: level strings the game itself loads
+    // (createObjectsFromSetup) are parsed as text only. The editor's own
+    // save file (saveLevel) asks for binary, which keeps the objects'
+    // unique IDs; a binary save is marked in the open undo log so the log
+    // can be matched to it on the next load.
+    std::string serializeLevel(LevelDataFormat format = LEVEL_FORMAT_TEXT);
     bool deserializeLevel(const std::string& data);
     
     std::string serializeSelection();
@@ -771,11 +847,13 @@ private:
     SelectionManager* m_selectionManager;                        // +0x39a0-0x39a8
     std::vector<GameObject*> m_selectedObjects;
     std::vector<GameObject*> m_copiedObjects;                    // +0x39b8-0x39c0
+    std::string m_binaryClipboard;
     
     // Undo/Redo system
-    UndoManager* m_undoManager;                                  // +0x3928, +0x3900 buffers
-    std::vector<UndoState> m_undoStack;
-    std::vector<UndoState> m_redoStack;
+    EditorUndoHistory m_undoHistory;                             // was UndoManager* +0x3928 (snapshots)
+    EditorUndoLog m_undoLog;
+    uint64_t m_levelStamp = 0;   // the binary save deserializeLevel loaded, 0 if none
+    std::string m_levelPath;     // loadLevel's file, where saveLevel writes
     
     // Object history (24-byte structs)
     struct ObjectHistoryEntry {
@@ -851,9 +929,26 @@ private:
     // Multithreading
     std::thread m_autoSaveThread;
     std::thread m_backgroundProcessingThread;
-    std::mutex m_editorMutex;
+    std::mutex m_editorMutex;                                    // autosave queue, quit flag, path
     std::atomic<bool> m_isProcessing;
     
+    // Incremental autosave. The pass state is editor-thread only; the
+    // queue is the hand-off to m_autoSaveThread, which alone owns m_autoSave.
+    AutoSaveChanges m_autoSaveChanges;
+    std::vector<int> m_autoSavePassIDs;
+    bool m_autoSavePassReset = false;
+    size_t m_autoSavePassCursor = 0;
+    bool m_autoSavePassActive = false;
+    bool m_autoSaveEnabled = false;
+    float m_autoSaveInterval = 60.0f;
+    float m_autoSaveTimer = 0.0f;
+    float m_autoSaveWorstStall = 0.0f;
+    std::string m_autoSavePath;
+    std::condition_variable m_autoSaveWake;
+    std::vector<AutoSaveBatch> m_autoSaveQueue;
+    bool m_autoSaveQuit = false;
+    EditorAutoSave m_autoSave;
+    
     // Statistics
     int m_objectCount;
     int m_editCount;
@@ -861,6 +956,44 @@ private:
     int m_saveCount;
     int m_undoCount;
     
+    // Spatial index (handles map back to objects through m_spatialObjects)
+    EditorSpatialIndex m_spatialIndex;
+    std::unordered_map<GameObject*, uint32_t> m_spatialHandles;
+    std::vector<GameObject*> m_spatialObjects;
+    std::vector<uint32_t> m_spatialScratch;
+    std::unordered_map<int, GameObject*> m_objectsByID;          // by m_uniqueID, for undo
+    // Object string keys GameObject doesn't model (EditorObjectRecord::extra),
+    // by m_uniqueID; objects without any have no entry.
+    std::unordered_map<int, std::string> m_objectExtras;
+    std::string m_levelHeader;   // "kS38,..." segment in front of the objects, saved back as is
+    EditorSelectionQueries m_selectionQueries;
+    
+    void selectInsidePolygon(const std::vector<cocos2d::CCPoint>& points, float minSpacing);
+    
+    GameObject* objectForID(int uniqueID) const;
+    void markObjectDirty(GameObject* obj);
+    void takeAutoSaveSlice();
+    void finishAutoSavePass();
+    void noteAutoSaveStall(std::chrono::steady_clock::time_point start);
+    void autoSaveThreadMain();
+    void startAutoSaveThread();
+    void stopAutoSaveThread();
+    void applyObjectMove(GameObject* obj, cocos2d::CCPoint delta);
+    void applyObjectRotation(GameObject* obj, float rotation);
+    void applyObjectScale(GameObject* obj, float scaleX, float scaleY);
+    void recordScaleChange(GameObject* obj, float oldScaleX, float oldScaleY);
+    // Add/remove without recording undo (loads, pastes and undo replays
+    // record for themselves, or not at all).
+    GameObject* spawnObject(int objectID, cocos2d::CCPoint position, int uniqueID = 0);
+    void destroyObject(GameObject* obj);
+    void modifyObjects(const std::vector<GameObject*>& objects, const char* description,
+                       const std::function<void(GameObject*)>& change);
+    std::string undoObjectString(std::vector<GameObject*> objects, std::vector<int>& ids);
+    std::vector<EditorObjectRecord> levelRecords();
+    EditorObjectRecord editorRecordOf(GameObject* obj) const;
+    GameObject* createObjectFromRecord(const EditorObjectRecord& record);
+    void applyRecord(GameObject* obj, const EditorObjectRecord& record);
+    
     // ... hundreds more member variables
 };
 
@@ -886,21 +1019,6 @@ private:
     cocos2d::CCNode* m_transformGizmo;
 };
 
-class UndoManager {
-public:
-    void pushState(const UndoState& state);
-    UndoState popUndo();
-    UndoState popRedo();
-    
-    void clear();
-    void setMaxStates(int max);
-    
-private:
-    std::stack<UndoState> m_undoStack;
-    std::stack<UndoState> m_redoStack;
-    int m_maxStates;
-};
-
 class GridManager {
 public:
     void setGrid(float size, cocos2d::ccColor4B color);
@@ -914,3 +1032,1006 @@ private:
 };
 
 // ... and 20+ more manager classes
+
+// ==============================================
+// SPATIAL INDEX & OBJECT QUERIES
+// ==============================================
+
+static BroadPhaseRect editorBoundsOf(GameObject* obj) {
+    cocos2d::CCRect rect = obj->getObjectRect();
+    return BroadPhaseRect::fromOriginSize(rect.origin.x, rect.origin.y, rect.size.width, rect.size.height);
+}
+
+// Overlap with positive area; objects that only share an edge (blocks laid
+// side by side on the grid) don't count.
+static bool editorBoundsOverlap(const BroadPhaseRect& a, const BroadPhaseRect& b) {
+    return a.minX < b.maxX && a.maxX > b.minX && a.minY < b.maxY && a.maxY > b.minY;
+}
+
+// What autosave, serialization and undo keep of an object.
+EditorObjectRecord LevelEditorLayer::editorRecordOf(GameObject* obj) const {
+    EditorObjectRecord record;
+    record.uniqueID = obj->m_uniqueID;
+    record.objectID = obj->m_objectID;
+    cocos2d::CCPoint position = obj->getPosition();
+    record.x = position.x;
+    record.y = position.y;
+    record.rotation = obj->getRotation();
+    record.scaleX = obj->getScaleX();
+    record.scaleY = obj->getScaleY();
+    record.zOrder = obj->getZOrder();
+    record.hidden = !obj->isVisible();
+    if (obj->m_baseColor) record.mainColor = static_cast<int16_t>(obj->m_baseColor->m_colorID);
+    if (obj->m_detailColor) record.detailColor = static_cast<int16_t>(obj->m_detailColor->m_colorID);
+    if (obj->m_groups) {
+        int count = std::min<int>(obj->m_groupCount, EditorObjectRecord::kMaxGroups);
+        for (int i = 0; i < count; ++i) record.groups[i] = (*obj->m_groups)[i];
+        record.groupCount = static_cast<uint8_t>(count);
+    }
+    auto extra = m_objectExtras.find(obj->m_uniqueID);
+    if (extra != m_objectExtras.end()) record.extra = extra->second;
+    return record;
+}
+
+void LevelEditorLayer::rebuildSpatialIndex() {
+    finishAutoSavePass();  // it still reads objects through the old maps
+    m_autoSaveChanges.markReset();
+    m_spatialIndex.clear();
+    m_spatialHandles.clear();
+    m_spatialObjects.clear();
+    m_objectsByID.clear();
+
+    cocos2d::CCArray* objects = m_objectContainer ? m_objectContainer->getChildren() : nullptr;
+    unsigned int count = objects ? objects->count() : 0;
+    m_spatialIndex.reserve(count);
+    m_spatialHandles.reserve(count);
+    m_spatialObjects.reserve(count);
+    for (unsigned int i = 0; i < count; ++i) {
+        indexObject(static_cast<GameObject*>(objects->objectAtIndex(i)));
+    }
+}
+
+void LevelEditorLayer::indexObject(GameObject* obj) {
+    if (!obj || m_spatialHandles.count(obj)) {
+        return;
+    }
+    uint32_t handle = m_spatialIndex.insert(editorBoundsOf(obj));
+    if (handle >= m_spatialObjects.size()) {
+        m_spatialObjects.resize(handle + 1, nullptr);
+    }
+    m_spatialObjects[handle] = obj;
+    m_spatialHandles.emplace(obj, handle);
+    m_objectsByID[obj->m_uniqueID] = obj;
+    markObjectDirty(obj);
+}
+
+void LevelEditorLayer::unindexObject(GameObject* obj) {
+    auto it = m_spatialHandles.find(obj);
+    if (it == m_spatialHandles.end()) {
+        return;
+    }
+    m_spatialIndex.remove(it->second);
+    m_spatialObjects[it->second] = nullptr;
+    m_spatialHandles.erase(it);
+    m_objectsByID.erase(obj->m_uniqueID);
+    m_autoSaveChanges.markRemoved(obj->m_uniqueID);
+}
+
+void LevelEditorLayer::refreshObjectBounds(GameObject* obj) {
+    auto it = m_spatialHandles.find(obj);
+    if (it == m_spatialHandles.end()) {
+        indexObject(obj);
+        return;
+    }
+    m_spatialIndex.update(it->second, editorBoundsOf(obj));
+    markObjectDirty(obj);
+}
+
+// ===== OBJECT LIFECYCLE =====
+
+// The level's objects are all in m_objectContainer by now, and this runs
+// again after a playtest, which may have moved them.
+void LevelEditorLayer::onEnter() {
+    cocos2d::CCLayerRGBA::onEnter();
+    rebuildSpatialIndex();
+    scheduleUpdate();
+}
+
+// The autosave thread writes through this layer, so it can't outlive it;
+// the pass in flight is finished and written first. Autosave starts the
+// thread again if the editor comes back.
+void LevelEditorLayer::onExit() {
+    stopAutoSaveThread();
+    cocos2d::CCLayerRGBA::onExit();
+}
+
+void LevelEditorLayer::update(float dt) {
+    updateEditor(dt);
+}
+
+// Playtest objects move and die every frame; autosave waits for the editor.
+void LevelEditorLayer::updateEditor(float dt) {
+    if (m_isPlaytesting) {
+        updatePlaytest(dt);
+        return;
+    }
+    updateAutoSave(dt);
+}
+
+// Playtest runs the level the way PlayLayer does.
+void LevelEditorLayer::updatePlaytest(float dt) {
+    updateLevel(dt);
+}
+
+// uniqueID != 0 brings an object back as itself (undo of a delete, a
+// binary load) unless another object already has that ID. New objects are
+// numbered past it so they never take an ID the undo history still names.
+GameObject* LevelEditorLayer::spawnObject(int objectID, cocos2d::CCPoint position, int uniqueID) {
+    GameObject* obj = GameObject::createWithKey(objectID);
+    if (!obj || !m_objectContainer) {
+        return nullptr;
+    }
+    if (uniqueID != 0 && !objectForID(uniqueID)) {
+        obj->m_uniqueID = uniqueID;
+        g_nextObjectID = std::max(g_nextObjectID, uniqueID + 1);
+    }
+    obj->setPosition(position);
+    m_objectContainer->addChild(obj);
+    indexObject(obj);
+    return obj;
+}
+
+void LevelEditorLayer::destroyObject(GameObject* obj) {
+    if (!obj) {
+        return;
+    }
+    deselectObject(obj);
+    unindexObject(obj);
+    m_objectExtras.erase(obj->m_uniqueID);
+    obj->removeFromParentAndCleanup(true);
+}
+
+GameObject* LevelEditorLayer::createObject(int objectID, cocos2d::CCPoint position) {
+    GameObject* obj = spawnObject(objectID, position);
+    if (obj) {
+        std::vector<int> ids;
+        std::string objects = undoObjectString({obj}, ids);
+        m_undoHistory.recordCreate(std::move(ids), objects);
+    }
+    return obj;
+}
+
+void LevelEditorLayer::removeObject(GameObject* obj) {
+    if (!obj) {
+        return;
+    }
+    std::vector<int> ids;
+    std::string objects = undoObjectString({obj}, ids);
+    m_undoHistory.recordRemove(std::move(ids), objects);
+    destroyObject(obj);
+}
+
+void LevelEditorLayer::deleteSelectedObjects() {
+    std::vector<GameObject*> removed = m_selectedObjects;
+    if (removed.empty()) {
+        return;
+    }
+    std::vector<int> ids;
+    std::string objects = undoObjectString(removed, ids);
+    m_undoHistory.recordRemove(std::move(ids), objects);
+    for (GameObject* obj : removed) {
+        destroyObject(obj);
+    }
+}
+
+// ===== TRANSFORMS (keep the index current, record undo) =====
+
+void LevelEditorLayer::applyObjectMove(GameObject* obj, cocos2d::CCPoint delta) {
+    obj->setPosition(obj->getPosition() + delta);
+    refreshObjectBounds(obj);
+}
+
+void LevelEditorLayer::applyObjectRotation(GameObject* obj, float rotation) {
+    obj->setRotation(rotation);
+    refreshObjectBounds(obj);
+}
+
+void LevelEditorLayer::applyObjectScale(GameObject* obj, float scaleX, float scaleY) {
+    obj->setScaleX(scaleX);
+    obj->setScaleY(scaleY);
+    refreshObjectBounds(obj);
+}
+
+void LevelEditorLayer::moveObject(GameObject* obj, cocos2d::CCPoint delta) {
+    if (!obj) return;
+    applyObjectMove(obj, delta);
+    m_undoHistory.recordTranslate({obj->m_uniqueID}, delta.x, delta.y);
+}
+
+void LevelEditorLayer::setObjectPosition(GameObject* obj, cocos2d::CCPoint position) {
+    if (!obj) return;
+    cocos2d::CCPoint delta = position - obj->getPosition();
+    applyObjectMove(obj, delta);
+    m_undoHistory.recordTranslate({obj->m_uniqueID}, delta.x, delta.y);
+}
+
+void LevelEditorLayer::rotateObject(GameObject* obj, float angle) {
+    if (!obj) return;
+    applyObjectRotation(obj, obj->getRotation() + angle);
+    m_undoHistory.recordRotate({obj->m_uniqueID}, angle);
+}
+
+void LevelEditorLayer::setObjectRotation(GameObject* obj, float rotation) {
+    if (!obj) return;
+    float oldRotation = obj->getRotation();
+    applyObjectRotation(obj, rotation);
+    m_undoHistory.recordProperty({obj->m_uniqueID}, UndoProperty::Rotation, {oldRotation}, rotation);
+}
+
+void LevelEditorLayer::scaleObject(GameObject* obj, float scaleX, float scaleY) {
+    if (!obj) return;
+    float oldScaleX = obj->getScaleX();
+    float oldScaleY = obj->getScaleY();
+    applyObjectScale(obj, oldScaleX * scaleX, oldScaleY * scaleY);
+    recordScaleChange(obj, oldScaleX, oldScaleY);
+}
+
+void LevelEditorLayer::setObjectScale(GameObject* obj, float scale) {
+    if (!obj) return;
+    float oldScaleX = obj->getScaleX();
+    float oldScaleY = obj->getScaleY();
+    applyObjectScale(obj, scale, scale);
+    recordScaleChange(obj, oldScaleX, oldScaleY);
+}
+
+// The old values, not the factor: multiplying back by 1/factor drifts, and
+// a zero scale has no inverse.
+void LevelEditorLayer::recordScaleChange(GameObject* obj, float oldScaleX, float oldScaleY) {
+    m_undoHistory.beginGroup("Scale");
+    if (obj->getScaleX() != oldScaleX) {
+        m_undoHistory.recordProperty({obj->m_uniqueID}, UndoProperty::ScaleX, {oldScaleX}, obj->getScaleX());
+    }
+    if (obj->getScaleY() != oldScaleY) {
+        m_undoHistory.recordProperty({obj->m_uniqueID}, UndoProperty::ScaleY, {oldScaleY}, obj->getScaleY());
+    }
+    m_undoHistory.endGroup();
+}
+
+void LevelEditorLayer::setObjectVisible(GameObject* obj, bool visible) {
+    if (!obj) return;
+    float wasVisible = obj->isVisible() ? 1.0f : 0.0f;
+    obj->setVisible(visible);
+    markObjectDirty(obj);
+    m_undoHistory.recordProperty({obj->m_uniqueID}, UndoProperty::Visible, {wasVisible}, visible ? 1.0f : 0.0f);
+}
+
+static float packColor(const cocos2d::_ccColor3B& color) {
+    return static_cast<float>((color.r << 16) | (color.g << 8) | color.b);
+}
+
+static cocos2d::_ccColor3B unpackColor(float value) {
+    auto packed = static_cast<uint32_t>(value);
+    return {static_cast<GLubyte>(packed >> 16), static_cast<GLubyte>(packed >> 8), static_cast<GLubyte>(packed)};
+}
+
+void LevelEditorLayer::setObjectColor(GameObject* obj, cocos2d::_ccColor3B color) {
+    if (!obj) return;
+    float oldColor = packColor(obj->getColor());
+    obj->setColor(color);
+    markObjectDirty(obj);
+    m_undoHistory.recordProperty({obj->m_uniqueID}, UndoProperty::Color, {oldColor}, packColor(color));
+}
+
+void LevelEditorLayer::applyColorToSelected(int colorID) {
+    std::vector<int> ids;
+    std::vector<float> oldColors;
+    for (GameObject* obj : m_selectedObjects) {
+        if (!obj->m_baseColor) continue;
+        ids.push_back(obj->m_uniqueID);
+        oldColors.push_back(static_cast<float>(obj->m_baseColor->m_colorID));
+        obj->m_baseColor->m_colorID = colorID;
+        markObjectDirty(obj);
+    }
+    m_undoHistory.recordProperty(ids, UndoProperty::MainColor, oldColors, static_cast<float>(colorID));
+}
+
+// Group membership is a list, so these record the objects before and after
+// (a Modify command) rather than a single value.
+void LevelEditorLayer::modifyObjects(const std::vector<GameObject*>& objects, const char* description,
+                                     const std::function<void(GameObject*)>& change) {
+    if (objects.empty()) return;
+    std::vector<int> ids;
+    std::string before = undoObjectString(objects, ids);
+    for (GameObject* obj : objects) {
+        change(obj);
+        markObjectDirty(obj);
+    }
+    std::string after = undoObjectString(objects, ids);
+    m_undoHistory.beginGroup(description);
+    m_undoHistory.recordModify(std::move(ids), before, after);
+    m_undoHistory.endGroup();
+}
+
+void LevelEditorLayer::setObjectGroup(GameObject* obj, int groupID) {
+    if (!obj) return;
+    modifyObjects({obj}, "Group", [groupID](GameObject* target) { target->addToGroup(groupID); });
+}
+
+void LevelEditorLayer::addToGroup(int groupID) {
+    modifyObjects(m_selectedObjects, "Add to group", [groupID](GameObject* obj) { obj->addToGroup(groupID); });
+}
+
+void LevelEditorLayer::removeFromGroup(int groupID) {
+    modifyObjects(m_selectedObjects, "Remove from group",
+                  [groupID](GameObject* obj) { obj->removeFromGroup(groupID); });
+}
+
+// One translate command for the whole selection, however many objects.
+void LevelEditorLayer::moveSelection(cocos2d::CCPoint delta) {
+    std::vector<int> ids;
+    ids.reserve(m_selectedObjects.size());
+    for (GameObject* obj : m_selectedObjects) {
+        applyObjectMove(obj, delta);
+        ids.push_back(obj->m_uniqueID);
+    }
+    m_undoHistory.recordTranslate(std::move(ids), delta.x, delta.y);
+}
+
+// ===== QUERIES =====
+
+GameObject* LevelEditorLayer::getObjectAtPosition(cocos2d::CCPoint position, float tolerance) {
+    m_spatialIndex.queryRadius(position.x, position.y, tolerance, m_spatialScratch);
+
+    // Prefer objects under the point itself, then the nearest, then the
+    // topmost, so clicking a block on top of a background deco picks the block.
+    GameObject* best = nullptr;
+    float bestDistanceSq = 0.0f;
+    int bestZOrder = 0;
+    for (uint32_t handle : m_spatialScratch) {
+        const BroadPhaseRect& rect = m_spatialIndex.bounds(handle);
+        float dx = std::max({rect.minX - position.x, 0.0f, position.x - rect.maxX});
+        float dy = std::max({rect.minY - position.y, 0.0f, position.y - rect.maxY});
+        float distanceSq = dx * dx + dy * dy;
+
+        GameObject* obj = m_spatialObjects[handle];
+        int zOrder = obj->getZOrder();
+        if (!best || distanceSq < bestDistanceSq || (distanceSq == bestDistanceSq && zOrder > bestZOrder)) {
+            best = obj;
+            bestDistanceSq = distanceSq;
+            bestZOrder = zOrder;
+        }
+    }
+    return best;
+}
+
+std::vector<GameObject*> LevelEditorLayer::getObjectsInRect(cocos2d::CCRect rect) {
+    m_spatialIndex.queryRect(BroadPhaseRect::fromOriginSize(rect.origin.x, rect.origin.y,
+                                                            rect.size.width, rect.size.height),
+                             m_spatialScratch);
+    std::vector<GameObject*> result;
+    result.reserve(m_spatialScratch.size());
+    for (uint32_t handle : m_spatialScratch) {
+        result.push_back(m_spatialObjects[handle]);
+    }
+    return result;
+}
+
+std::vector<GameObject*> LevelEditorLayer::getObjectsNearPoint(cocos2d::CCPoint point, float radius) {
+    m_spatialIndex.queryRadius(point.x, point.y, radius, m_spatialScratch);
+    std::vector<GameObject*> result;
+    result.reserve(m_spatialScratch.size());
+    for (uint32_t handle : m_spatialScratch) {
+        result.push_back(m_spatialObjects[handle]);
+    }
+    return result;
+}
+
+void LevelEditorLayer::selectInRect(cocos2d::CCRect rect, SelectionMode mode) {
+    m_selectionMode = mode;
+    for (GameObject* obj : getObjectsInRect(rect)) {
+        selectObject(obj, true);
+    }
+}
+
+// ===== LASSO / POLYGON / MAGIC WAND =====
+
+// Freehand lasso points closer than this are merged; a drag reports one
+// point per touch move.
+static constexpr float kLassoMinSpacing = 2.0f;
+
+void LevelEditorLayer::selectInsidePolygon(const std::vector<cocos2d::CCPoint>& points, float minSpacing) {
+    std::vector<SelectionPoint> outline;
+    outline.reserve(points.size());
+    for (const cocos2d::CCPoint& point : points) {
+        outline.push_back({point.x, point.y});
+    }
+
+    SelectionPolygon polygon;
+    polygon.assign(outline.data(), outline.size(), minSpacing);
+    m_selectionQueries.insidePolygon(m_spatialIndex, polygon, m_spatialScratch);
+    for (uint32_t handle : m_spatialScratch) {
+        selectObject(m_spatialObjects[handle], true);
+    }
+}
+
+void LevelEditorLayer::selectWithLasso(const std::vector<cocos2d::CCPoint>& points) {
+    m_selectionMode = SELECT_LASSO;
+    selectInsidePolygon(points, kLassoMinSpacing);
+}
+
+void LevelEditorLayer::selectWithPolygon(const std::vector<cocos2d::CCPoint>& points) {
+    m_selectionMode = SELECT_POLYGON;
+    selectInsidePolygon(points, 0.0f);
+}
+
+// Selects the connected run of objects of the same type as the one under
+// point; tolerance is the largest gap (in units) bridged between neighbours.
+void LevelEditorLayer::selectWithMagicWand(cocos2d::CCPoint point, float tolerance) {
+    m_selectionMode = SELECT_MAGIC_WAND;
+
+    GameObject* seedObject = getObjectAtPosition(point);
+    auto seed = m_spatialHandles.find(seedObject);
+    if (seed == m_spatialHandles.end()) {
+        return;
+    }
+
+    auto sameType = [this](uint32_t seedHandle, uint32_t candidate) {
+        return m_spatialObjects[candidate]->m_objectType == m_spatialObjects[seedHandle]->m_objectType;
+    };
+    m_selectionQueries.magicWand(m_spatialIndex, seed->second, std::max(tolerance, 0.0f), sameType,
+                                 m_spatialScratch);
+    for (uint32_t handle : m_spatialScratch) {
+        selectObject(m_spatialObjects[handle], true);
+    }
+}
+
+bool LevelEditorLayer::objectsOverlap(GameObject* obj1, GameObject* obj2) {
+    if (!obj1 || !obj2 || obj1 == obj2) {
+        return false;
+    }
+    auto bounds = [this](GameObject* obj) {
+        auto it = m_spatialHandles.find(obj);
+        return it != m_spatialHandles.end() ? m_spatialIndex.bounds(it->second) : editorBoundsOf(obj);
+    };
+    return editorBoundsOverlap(bounds(obj1), bounds(obj2));
+}
+
+bool LevelEditorLayer::canPlaceObject(GameObject* obj, cocos2d::CCPoint position) {
+    if (!obj) {
+        return false;
+    }
+
+    // The object's bounds as if it stood at position.
+    BroadPhaseRect placed = editorBoundsOf(obj);
+    cocos2d::CCPoint current = obj->getPosition();
+    float dx = position.x - current.x;
+    float dy = position.y - current.y;
+    placed = {placed.minX + dx, placed.minY + dy, placed.maxX + dx, placed.maxY + dy};
+
+    m_spatialIndex.queryRect(placed, m_spatialScratch);
+    for (uint32_t handle : m_spatialScratch) {
+        if (m_spatialObjects[handle] != obj && editorBoundsOverlap(placed, m_spatialIndex.bounds(handle))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ==============================================
+// UNDO / REDO
+// ==============================================
+
+GameObject* LevelEditorLayer::objectForID(int uniqueID) const {
+    auto it = m_objectsByID.find(uniqueID);
+    return it != m_objectsByID.end() ? it->second : nullptr;
+}
+
+void LevelEditorLayer::undo() {
+    if (m_undoHistory.undo(*this)) {
+        ++m_undoCount;
+        m_needsSelectionUpdate = true;
+    }
+}
+
+void LevelEditorLayer::redo() {
+    if (m_undoHistory.redo(*this)) {
+        m_needsSelectionUpdate = true;
+    }
+}
+
+void LevelEditorLayer::clearUndoHistory() {
+    m_undoHistory.clear();
+}
+
+void LevelEditorLayer::setMaxUndoSteps(int steps) {
+    m_undoHistory.setMaxSteps(steps > 0 ? static_cast<size_t>(steps) : 0);
+}
+
+void LevelEditorLayer::setUndoMemoryLimit(size_t bytes) {
+    m_undoHistory.setByteBudget(bytes);
+}
+
+size_t LevelEditorLayer::getUndoMemoryUsage() const {
+    return m_undoHistory.bytesUsed();
+}
+
+bool LevelEditorLayer::openUndoLog(const std::string& levelPath) {
+    closeUndoLog();
+    if (!m_undoLog.open(levelPath + ".undo", m_levelStamp)) {
+        return false;
+    }
+    m_undoHistory.attachLog(&m_undoLog);
+    return true;
+}
+
+void LevelEditorLayer::closeUndoLog() {
+    m_undoHistory.detachLog();
+    m_undoLog.close();
+}
+
+// Same binary format as the undo log, compacted to the live steps.
+std::string LevelEditorLayer::serializeUndoHistory() {
+    return m_undoHistory.serialize();
+}
+
+bool LevelEditorLayer::deserializeUndoHistory(const std::string& data) {
+    return m_undoHistory.deserialize(data);
+}
+
+void LevelEditorLayer::beginUndoGroup(const std::string& name) {
+    m_undoHistory.beginGroup(name);
+}
+
+void LevelEditorLayer::endUndoGroup() {
+    m_undoHistory.endGroup();
+}
+
+void LevelEditorLayer::cancelUndoGroup() {
+    m_undoHistory.cancelGroup(*this);
+}
+
+// Changes are recorded as they are made, so there is no state to capture
+// any more; the description labels the next recorded step.
+void LevelEditorLayer::saveUndoState(const std::string& description) {
+    m_undoHistory.setNextDescription(description);
+}
+
+// Undoes or redoes until `index` steps remain undoable.
+void LevelEditorLayer::loadUndoState(int index) {
+    if (index < 0) return;
+    while (m_undoHistory.undoCount() > static_cast<size_t>(index) && m_undoHistory.undo(*this)) {}
+    while (m_undoHistory.undoCount() < static_cast<size_t>(index) && m_undoHistory.redo(*this)) {}
+    m_needsSelectionUpdate = true;
+}
+
+bool LevelEditorLayer::canUndo() const { return m_undoHistory.undoCount() > 0; }
+bool LevelEditorLayer::canRedo() const { return m_undoHistory.redoCount() > 0; }
+int LevelEditorLayer::getUndoCount() const { return static_cast<int>(m_undoHistory.undoCount()); }
+int LevelEditorLayer::getRedoCount() const { return static_cast<int>(m_undoHistory.redoCount()); }
+
+std::string LevelEditorLayer::getUndoDescription(int index) const {
+    return index >= 0 ? m_undoHistory.undoDescription(static_cast<size_t>(index)) : std::string();
+}
+
+std::string LevelEditorLayer::getRedoDescription(int index) const {
+    return index >= 0 ? m_undoHistory.redoDescription(static_cast<size_t>(index)) : std::string();
+}
+
+// ===== EditorUndoTarget =====
+
+void LevelEditorLayer::undoTranslate(const std::vector<int>& ids, float dx, float dy) {
+    for (int id : ids) {
+        if (GameObject* obj = objectForID(id)) applyObjectMove(obj, {dx, dy});
+    }
+}
+
+void LevelEditorLayer::undoRotate(const std::vector<int>& ids, float degrees) {
+    for (int id : ids) {
+        if (GameObject* obj = objectForID(id)) applyObjectRotation(obj, obj->getRotation() + degrees);
+    }
+}
+
+void LevelEditorLayer::undoSetProperty(int id, UndoProperty property, float value) {
+    GameObject* obj = objectForID(id);
+    if (!obj) return;
+
+    switch (property) {
+    case UndoProperty::Rotation: applyObjectRotation(obj, value); break;
+    case UndoProperty::ScaleX:   applyObjectScale(obj, value, obj->getScaleY()); break;
+    case UndoProperty::ScaleY:   applyObjectScale(obj, obj->getScaleX(), value); break;
+    case UndoProperty::Visible:  obj->setVisible(value != 0.0f); markObjectDirty(obj); break;
+    case UndoProperty::ZOrder:   obj->setZOrder(static_cast<int>(value)); markObjectDirty(obj); break;
+    case UndoProperty::MainColor:
+        if (obj->m_baseColor) obj->m_baseColor->m_colorID = static_cast<int>(value);
+        markObjectDirty(obj);
+        break;
+    case UndoProperty::Color:    obj->setColor(unpackColor(value)); markObjectDirty(obj); break;
+    default: break;
+    }
+}
+
+// Object strings come from undoObjectString: ascending unique IDs, the
+// same order as ids.
+void LevelEditorLayer::undoCreate(const std::vector<int>& ids, std::string_view objectString) {
+    std::vector<EditorObjectRecord> records;
+    if (!parseObjectStrings(objectString, records)) return;
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (i < ids.size()) records[i].uniqueID = ids[i];
+        createObjectFromRecord(records[i]);
+    }
+}
+
+void LevelEditorLayer::undoRemove(const std::vector<int>& ids) {
+    for (int id : ids) {
+        destroyObject(objectForID(id));
+    }
+}
+
+void LevelEditorLayer::undoModify(const std::vector<int>& ids, std::string_view objectString) {
+    std::vector<EditorObjectRecord> records;
+    if (!parseObjectStrings(objectString, records)) return;
+    for (size_t i = 0; i < records.size() && i < ids.size(); ++i) {
+        if (GameObject* obj = objectForID(ids[i])) applyRecord(obj, records[i]);
+    }
+}
+
+std::string LevelEditorLayer::undoObjectString(std::vector<GameObject*> objects, std::vector<int>& ids) {
+    std::sort(objects.begin(), objects.end(),
+              [](GameObject* a, GameObject* b) { return a->m_uniqueID < b->m_uniqueID; });
+    objects.erase(std::unique(objects.begin(), objects.end()), objects.end());
+
+    ids.clear();
+    std::vector<EditorObjectRecord> records;
+    records.reserve(objects.size());
+    for (GameObject* obj : objects) {
+        ids.push_back(obj->m_uniqueID);
+        records.push_back(editorRecordOf(obj));
+    }
+    std::string text;
+    appendObjectStrings(records, text);
+    return text;
+}
+
+// ==============================================
+// AUTOSAVE
+// ==============================================
+
+// Objects copied for the autosave thread per frame; a record is a few
+// property reads, so a slice costs about a millisecond at most.
+static constexpr size_t kAutoSaveSliceObjects = 8192;
+
+void LevelEditorLayer::markObjectDirty(GameObject* obj) {
+    m_autoSaveChanges.markChanged(obj->m_uniqueID);
+}
+
+// Written on the editor thread only; the lock is for the autosave thread's
+// reads.
+void LevelEditorLayer::setAutoSavePath(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_editorMutex);
+    m_autoSavePath = path;
+}
+
+float LevelEditorLayer::getAutoSaveWorstStall() const {
+    return m_autoSaveWorstStall;
+}
+
+void LevelEditorLayer::enableAutoSave(bool enabled, float interval) {
+    m_autoSaveEnabled = enabled;
+    m_autoSaveInterval = interval;
+    m_autoSaveTimer = 0.0f;
+    if (enabled) {
+        startAutoSaveThread();
+    } else {
+        stopAutoSaveThread();
+    }
+}
+
+void LevelEditorLayer::updateAutoSave(float dt) {
+    if (m_autoSavePassActive) {
+        auto start = std::chrono::steady_clock::now();
+        takeAutoSaveSlice();
+        noteAutoSaveStall(start);
+        return;
+    }
+    if (!m_autoSaveEnabled) {
+        return;
+    }
+    m_autoSaveTimer += dt;
+    if (m_autoSaveTimer >= m_autoSaveInterval) {
+        autoSave();
+    }
+}
+
+// Starts a pass over everything changed since the previous one. An object
+// edited again before the pass reaches it is saved as it is then; edits to
+// objects the pass has already copied go to the next pass.
+void LevelEditorLayer::autoSave() {
+    m_autoSaveTimer = 0.0f;
+    if (m_autoSavePassActive || m_autoSaveChanges.empty()) {
+        return;
+    }
+    startAutoSaveThread();
+
+    auto start = std::chrono::steady_clock::now();
+    m_autoSaveChanges.take(m_autoSavePassIDs, m_autoSavePassReset);
+    m_autoSavePassCursor = 0;
+    m_autoSavePassActive = true;
+    takeAutoSaveSlice();
+    noteAutoSaveStall(start);
+}
+
+void LevelEditorLayer::takeAutoSaveSlice() {
+    AutoSaveBatch batch;
+    batch.reset = m_autoSavePassReset;
+    m_autoSavePassReset = false;
+
+    size_t end = std::min(m_autoSavePassIDs.size(), m_autoSavePassCursor + kAutoSaveSliceObjects);
+    batch.changed.reserve(end - m_autoSavePassCursor);
+    for (; m_autoSavePassCursor < end; ++m_autoSavePassCursor) {
+        int id = m_autoSavePassIDs[m_autoSavePassCursor];
+        switch (m_autoSaveChanges.consume(id)) {
+        case AutoSaveChanges::kChanged:
+            if (GameObject* obj = objectForID(id)) {
+                batch.changed.push_back(editorRecordOf(obj));
+                break;
+            }
+            batch.removed.push_back(id);
+            break;
+        case AutoSaveChanges::kRemoved:
+            batch.removed.push_back(id);
+            break;
+        default:
+            break;
+        }
+    }
+    batch.complete = m_autoSavePassCursor == m_autoSavePassIDs.size();
+    if (batch.complete) {
+        batch.levelHeader = m_levelHeader;
+        m_autoSavePassActive = false;
+        m_autoSavePassIDs.clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_editorMutex);
+        m_autoSaveQueue.push_back(std::move(batch));
+    }
+    m_autoSaveWake.notify_one();
+}
+
+void LevelEditorLayer::noteAutoSaveStall(std::chrono::steady_clock::time_point start) {
+    std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    m_autoSaveWorstStall = std::max(m_autoSaveWorstStall, elapsed.count());
+}
+
+void LevelEditorLayer::autoSaveThreadMain() {
+    std::unique_lock<std::mutex> lock(m_editorMutex);
+    for (;;) {
+        m_autoSaveWake.wait(lock, [this] { return !m_autoSaveQueue.empty() || m_autoSaveQuit; });
+        if (m_autoSaveQueue.empty()) {
+            return;
+        }
+
+        std::vector<AutoSaveBatch> batches;
+        batches.swap(m_autoSaveQueue);
+        std::string path = m_autoSavePath;
+        lock.unlock();
+
+        // Write once per finished pass; batches after the last complete one
+        // belong to a pass still being sliced.
+        size_t lastComplete = batches.size();
+        for (size_t i = 0; i < batches.size(); ++i) {
+            if (batches[i].complete) lastComplete = i;
+        }
+        for (size_t i = 0; i < batches.size(); ++i) {
+            m_autoSave.apply(batches[i]);
+            if (i == lastComplete) {
+                m_autoSave.write(path);
+            }
+        }
+
+        lock.lock();
+    }
+}
+
+void LevelEditorLayer::startAutoSaveThread() {
+    if (m_autoSaveThread.joinable()) {
+        return;
+    }
+    if (m_autoSavePath.empty()) {
+        setAutoSavePath(cocos2d::CCFileUtils::sharedFileUtils()->getWritablePath() + "editor_autosave.dat");
+    }
+    m_autoSaveQuit = false;
+    m_autoSaveThread = std::thread(&LevelEditorLayer::autoSaveThreadMain, this);
+}
+
+void LevelEditorLayer::finishAutoSavePass() {
+    while (m_autoSavePassActive) {
+        takeAutoSaveSlice();
+    }
+}
+
+// Finishes the queued passes and joins the thread.
+void LevelEditorLayer::stopAutoSaveThread() {
+    if (!m_autoSaveThread.joinable()) {
+        return;
+    }
+    finishAutoSavePass();
+    {
+        std::lock_guard<std::mutex> lock(m_editorMutex);
+        m_autoSaveQuit = true;
+    }
+    m_autoSaveWake.notify_one();
+    m_autoSaveThread.join();
+}
+
+// Replaces the level with the autosaved one, header included. Text keeps
+// no unique IDs, so the objects come back with new ones and the undo
+// history starts over (deserializeLevel).
+void LevelEditorLayer::restoreAutoSave() {
+    std::string level;
+    if (m_autoSavePath.empty() || !EditorAutoSave::read(m_autoSavePath, level) || level.empty()) {
+        return;
+    }
+    deserializeLevel(level);
+}
+
+// ==============================================
+// LEVEL DATA
+// ==============================================
+
+std::vector<EditorObjectRecord> LevelEditorLayer::levelRecords() {
+    std::vector<EditorObjectRecord> records;
+    cocos2d::CCArray* objects = m_objectContainer ? m_objectContainer->getChildren() : nullptr;
+    unsigned int count = objects ? objects->count() : 0;
+    records.reserve(count);
+    for (unsigned int i = 0; i < count; ++i) {
+        records.push_back(editorRecordOf(static_cast<GameObject*>(objects->objectAtIndex(i))));
+    }
+    return records;
+}
+
+// Not recorded for undo.
+GameObject* LevelEditorLayer::createObjectFromRecord(const EditorObjectRecord& record) {
+    GameObject* obj = spawnObject(record.objectID, cocos2d::CCPoint(record.x, record.y), record.uniqueID);
+    if (obj) {
+        applyRecord(obj, record);
+    }
+    return obj;
+}
+
+// Sets every property the record models; groups and the keys kept in
+// record.extra are replaced.
+void LevelEditorLayer::applyRecord(GameObject* obj, const EditorObjectRecord& record) {
+    obj->setPosition(cocos2d::CCPoint(record.x, record.y));
+    obj->setRotation(record.rotation);
+    obj->setScaleX(record.scaleX);
+    obj->setScaleY(record.scaleY);
+    obj->setZOrder(record.zOrder);
+    obj->setVisible(!record.hidden);
+    if (obj->m_baseColor && record.mainColor != 0) obj->m_baseColor->m_colorID = record.mainColor;
+    if (obj->m_detailColor && record.detailColor != 0) obj->m_detailColor->m_colorID = record.detailColor;
+    while (obj->m_groups && obj->m_groupCount > 0) {
+        obj->removeFromGroup((*obj->m_groups)[0]);
+    }
+    for (int i = 0; i < record.groupCount; ++i) {
+        obj->addToGroup(record.groups[i]);
+    }
+    if (record.extra.empty()) {
+        m_objectExtras.erase(obj->m_uniqueID);
+    } else {
+        m_objectExtras[obj->m_uniqueID] = record.extra;
+    }
+    refreshObjectBounds(obj);
+}
+
+std::string LevelEditorLayer::serializeLevel(LevelDataFormat format) {
+    std::vector<EditorObjectRecord> records = levelRecords();
+    std::string data;
+    if (format == LEVEL_FORMAT_TEXT) {
+        data = m_levelHeader;
+        if (!data.empty() && !records.empty()) data.push_back(';');
+        appendObjectStrings(records, data);
+    } else if (!LevelBinaryFormat::write(records, format == LEVEL_FORMAT_BINARY_COMPRESSED, data, m_levelHeader)) {
+        data.clear();
+    } else if (m_undoLog.isOpen()) {
+        m_undoLog.appendLevel(EditorUndoLog::levelStampOf(data));
+    }
+    return data;
+}
+
+bool LevelEditorLayer::deserializeLevel(const std::string& data) {
+    std::vector<EditorObjectRecord> records;
+    std::string levelHeader;
+    bool ok = LevelBinaryFormat::isBinary(data) ? LevelBinaryFormat::read(data, records, &levelHeader)
+                                                : parseObjectStrings(data, records, &levelHeader);
+    if (!ok) {
+        return false;
+    }
+
+    // The running autosave pass reads objects through the maps, so it has
+    // to finish before they go; the undo steps all refer to old objects.
+    finishAutoSavePass();
+    deselectAll();
+    closeUndoLog();
+    clearUndoHistory();
+    m_levelStamp = LevelBinaryFormat::isBinary(data) ? EditorUndoLog::levelStampOf(data) : 0;
+    if (m_objectContainer) {
+        m_objectContainer->removeAllChildrenWithCleanup(true);
+    }
+    m_objectExtras.clear();
+    m_levelHeader = std::move(levelHeader);
+    rebuildSpatialIndex();
+
+    for (const EditorObjectRecord& record : records) {
+        createObjectFromRecord(record);
+    }
+    return true;
+}
+
+void LevelEditorLayer::loadLevel(const std::string& filepath) {
+    MappedFile file;
+    if (!file.open(filepath) ||
+        !deserializeLevel(std::string(reinterpret_cast<const char*>(file.data()), file.size()))) {
+        return;
+    }
+    m_levelPath = filepath;
+    openUndoLog(filepath);
+}
+
+// Binary whatever the level was loaded from: serializeLevel stamps the open
+// undo log with these bytes, and loadLevel restores the log only for them.
+// Written to a temp file renamed over the save, so a failed write leaves
+// the previous save (which the log may still match) in place.
+void LevelEditorLayer::saveLevel() {
+    if (m_levelPath.empty()) {
+        return;
+    }
+    std::string data = serializeLevel(LEVEL_FORMAT_BINARY_COMPRESSED);
+    if (data.empty()) {
+        return;
+    }
+    std::string tempPath = m_levelPath + ".tmp";
+    FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        return;
+    }
+    bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok || std::rename(tempPath.c_str(), m_levelPath.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+    }
+}
+
+// Uncompressed: a clipboard copy is read back once, soon, in this process.
+void LevelEditorLayer::copyAsBinary() {
+    std::vector<EditorObjectRecord> records;
+    records.reserve(m_selectedObjects.size());
+    for (GameObject* obj : m_selectedObjects) {
+        records.push_back(editorRecordOf(obj));
+    }
+    if (!LevelBinaryFormat::write(records, false, m_binaryClipboard)) {
+        m_binaryClipboard.clear();
+    }
+}
+
+void LevelEditorLayer::pasteFromBinary(const std::string& data) {
+    std::vector<EditorObjectRecord> records;
+    if (!LevelBinaryFormat::read(data, records)) {
+        return;
+    }
+    std::vector<GameObject*> pasted;
+    pasted.reserve(records.size());
+    for (EditorObjectRecord& record : records) {
+        record.uniqueID = 0;  // copies, not the originals
+        if (GameObject* obj = createObjectFromRecord(record)) pasted.push_back(obj);
+    }
+
+    std::vector<int> ids;
+    std::string objects = undoObjectString(pasted, ids);
+    m_undoHistory.beginGroup("Paste");
+    m_undoHistory.recordCreate(std::move(ids), objects);
+    m_undoHistory.endGroup();
+
+    deselectAll();
+    selectObjects(pasted);
+}
@@ -0,0 +1,198 @@
+// LocalLevelCatalog.cpp
+#include "LocalLevelCatalog.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+// The catalog is written and mapped on the same device; every supported
+// target is little-endian, so entries are used in place without swapping.
+
+CatalogSource CatalogSource::of(const std::string& path) {
+    CatalogSource source;
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0) {
+        return source;
+    }
+    source.size = static_cast<uint64_t>(info.st_size);
+#if defined(__APPLE__)
+    source.mtimeNs = int64_t(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+    source.mtimeNs = int64_t(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+    return source;
+}
+
+bool LocalLevelCatalog::open(const std::string& path, const CatalogSource& source) {
+    close();
+    if (!m_file.open(path)) {
+        return false;
+    }
+
+    const uint8_t* base = m_file.data();
+    size_t size = m_file.size();
+    if (size < sizeof(CatalogHeader)) {
+        close();
+        return false;
+    }
+
+    CatalogHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, "GDLC", 4) != 0 || header.version != kVersion || header.fileSize != size) {
+        close();
+        return false;
+    }
+    if (header.sourceSize != source.size || header.sourceMtimeNs != source.mtimeNs) {
+        close();
+        return false;  // the save file changed since; stale
+    }
+
+    // Bounds-check the fixed tables once; offsets inside entries are checked
+    // when they are used.
+    uint64_t entriesEnd = sizeof(CatalogHeader) + uint64_t(header.entryCount) * sizeof(CatalogEntry);
+    uint64_t orderEnd = uint64_t(header.nameOrderOffset) + uint64_t(header.entryCount) * sizeof(uint32_t);
+    if (entriesEnd > size || header.nameOrderOffset < entriesEnd || orderEnd > size ||
+        header.nameOrderOffset % alignof(uint32_t) != 0) {
+        close();
+        return false;
+    }
+
+    m_entries = reinterpret_cast<const CatalogEntry*>(base + sizeof(CatalogHeader));
+    m_nameOrder = reinterpret_cast<const uint32_t*>(base + header.nameOrderOffset);
+    m_entryCount = header.entryCount;
+    return true;
+}
+
+void LocalLevelCatalog::close() {
+    m_file.close();
+    m_entries = nullptr;
+    m_nameOrder = nullptr;
+    m_entryCount = 0;
+}
+
+// ============================================================================
+// Lookups
+// ============================================================================
+
+const CatalogEntry* LocalLevelCatalog::findByID(int32_t levelID) const {
+    const CatalogEntry* end = m_entries + m_entryCount;
+    const CatalogEntry* found = std::lower_bound(m_entries, end, levelID,
+        [](const CatalogEntry& entry, int32_t id) { return entry.levelID < id; });
+    return (found != end && found->levelID == levelID) ? found : nullptr;
+}
+
+const CatalogEntry* LocalLevelCatalog::findByName(std::string_view name) const {
+    const uint32_t* end = m_nameOrder + m_entryCount;
+    const uint32_t* found = std::lower_bound(m_nameOrder, end, name,
+        [this](uint32_t index, std::string_view key) {
+            return index < m_entryCount && nameOf(m_entries[index]) < key;
+        });
+    if (found == end || *found >= m_entryCount) {
+        return nullptr;
+    }
+    const CatalogEntry& entry = m_entries[*found];
+    return nameOf(entry) == name ? &entry : nullptr;
+}
+
+std::string_view LocalLevelCatalog::nameOf(const CatalogEntry& entry) const {
+    if (uint64_t(entry.nameOffset) + entry.nameLength > m_file.size()) {
+        return {};
+    }
+    return {reinterpret_cast<const char*>(m_file.data() + entry.nameOffset), entry.nameLength};
+}
+
+std::string_view LocalLevelCatalog::levelDataOf(const CatalogEntry& entry) const {
+    if (entry.dataOffset > m_file.size() || entry.dataLength > m_file.size() - entry.dataOffset) {
+        return {};
+    }
+    m_file.willNeed(static_cast<size_t>(entry.dataOffset), entry.dataLength);
+    return {reinterpret_cast<const char*>(m_file.data() + entry.dataOffset), entry.dataLength};
+}
+
+// ============================================================================
+// Writing
+// ============================================================================
+
+bool LocalLevelCatalog::write(const std::string& path, std::vector<LevelRecord> levels, const CatalogSource& source) {
+    std::sort(levels.begin(), levels.end(), [](const LevelRecord& a, const LevelRecord& b) {
+        return a.info.levelID < b.info.levelID;
+    });
+
+    uint32_t count = static_cast<uint32_t>(levels.size());
+    uint64_t nameOrderOffset = sizeof(CatalogHeader) + uint64_t(count) * sizeof(CatalogEntry);
+    uint64_t namesOffset = nameOrderOffset + uint64_t(count) * sizeof(uint32_t);
+
+    uint64_t dataOffset = namesOffset;
+    for (const LevelRecord& level : levels) {
+        dataOffset += std::min<size_t>(level.name.size(), UINT16_MAX);
+    }
+
+    std::vector<CatalogEntry> entries(count);
+    uint64_t nameCursor = namesOffset;
+    uint64_t dataCursor = dataOffset;
+    for (uint32_t i = 0; i < count; ++i) {
+        const LevelRecord& level = levels[i];
+        CatalogEntry& entry = entries[i];
+        std::memset(&entry, 0, sizeof(entry));
+        entry.levelID = level.info.levelID;
+        entry.levelVersion = level.info.levelVersion;
+        entry.songID = level.info.songID;
+        entry.objectCount = level.info.objectCount;
+        entry.nameOffset = static_cast<uint32_t>(nameCursor);
+        entry.nameLength = static_cast<uint16_t>(std::min<size_t>(level.name.size(), UINT16_MAX));
+        entry.dataOffset = dataCursor;
+        entry.dataLength = static_cast<uint32_t>(level.compressedData.size());
+        nameCursor += entry.nameLength;
+        dataCursor += entry.dataLength;
+    }
+    if (nameCursor > UINT32_MAX) {
+        return false;  // name offsets are 32-bit
+    }
+
+    std::vector<uint32_t> nameOrder(count);
+    for (uint32_t i = 0; i < count; ++i) nameOrder[i] = i;
+    std::stable_sort(nameOrder.begin(), nameOrder.end(), [&](uint32_t a, uint32_t b) {
+        return levels[a].name.substr(0, entries[a].nameLength) <
+               levels[b].name.substr(0, entries[b].nameLength);
+    });
+
+    CatalogHeader header;
+    std::memcpy(header.magic, "GDLC", 4);
+    header.version = kVersion;
+    header.reserved = 0;
+    header.entryCount = count;
+    header.nameOrderOffset = static_cast<uint32_t>(nameOrderOffset);
+    header.fileSize = dataCursor;
+    header.sourceSize = source.size;
+    header.sourceMtimeNs = source.mtimeNs;
+
+    std::string tempPath = path + ".tmp";
+    FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && (count == 0 || std::fwrite(entries.data(), sizeof(CatalogEntry), count, file) == count);
+    ok = ok && (count == 0 || std::fwrite(nameOrder.data(), sizeof(uint32_t), count, file) == count);
+    for (uint32_t i = 0; ok && i < count; ++i) {
+        ok = std::fwrite(levels[i].name.data(), 1, entries[i].nameLength, file) == entries[i].nameLength;
+    }
+    for (uint32_t i = 0; ok && i < count; ++i) {
+        std::string_view data = levels[i].compressedData;
+        ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    }
+    // The catalog replaces the only index of the player's levels, so it must
+    // be on disk before the rename makes it current.
+    ok = ok && std::fflush(file) == 0 && ::fsync(fileno(file)) == 0;
+    ok = (std::fclose(file) == 0) && ok;
+
+    if (!ok || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
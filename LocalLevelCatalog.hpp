@@ -0,0 +1,118 @@
+#pragma once
+
+#include "main.hpp"
+#include "MappedFile.hpp"
+
+#include <string_view>
+
+// ==============================================
+// MEMORY-MAPPED LOCAL LEVEL CATALOG
+// ==============================================
+//
+// On-disk catalog of the player's saved levels, so startup doesn't have to
+// decode every level into a GJGameLevel. The file is mapped read-only; the
+// ID and name indices are binary-searched in place, and a level's compressed
+// level string is only touched (paged in) when that level is opened.
+//
+// A catalog records the size and mtime of the CCLocalLevels.dat it was
+// written against; open() rejects it once that file has changed, the same
+// way it rejects a truncated one, and the caller rebuilds it.
+//
+// Layout (little-endian):
+//   CatalogHeader
+//   CatalogEntry[entryCount]      sorted by levelID
+//   uint32_t[entryCount]          entry indices sorted by name
+//   name bytes                    not NUL-terminated
+//   level string bytes            compressed, as saved by LocalLevelManager
+
+#pragma pack(push, 1)
+struct CatalogHeader {
+    char     magic[4];        // "GDLC"
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t entryCount;
+    uint32_t nameOrderOffset;
+    uint64_t fileSize;        // truncated files are rejected
+    uint64_t sourceSize;      // CatalogSource of CCLocalLevels.dat
+    int64_t  sourceMtimeNs;
+};
+
+struct CatalogEntry {
+    int32_t  levelID;
+    uint32_t nameOffset;
+    uint16_t nameLength;
+    uint16_t levelVersion;
+    int32_t  songID;
+    uint32_t objectCount;
+    uint64_t dataOffset;      // compressed level string
+    uint32_t dataLength;
+    uint32_t reserved;
+};
+#pragma pack(pop)
+
+// Fingerprint of the save file a catalog mirrors; all zero if it is missing.
+struct CatalogSource {
+    uint64_t size = 0;
+    int64_t  mtimeNs = 0;
+
+    static CatalogSource of(const std::string& path);
+
+    bool operator==(const CatalogSource& other) const {
+        return size == other.size && mtimeNs == other.mtimeNs;
+    }
+    bool operator!=(const CatalogSource& other) const { return !(*this == other); }
+};
+
+// Metadata kept per level besides its name and data.
+struct CatalogLevelInfo {
+    int32_t  levelID = 0;
+    uint16_t levelVersion = 0;
+    int32_t  songID = 0;
+    uint32_t objectCount = 0;
+};
+
+// What a level list needs; the name points into the catalog mapping.
+struct LocalLevelSummary {
+    CatalogLevelInfo info;
+    std::string_view name;
+};
+
+class LocalLevelCatalog {
+public:
+    static constexpr uint16_t kVersion = 2;
+
+    // False if the file is missing, damaged, or was written against a
+    // different source than `source`.
+    bool open(const std::string& path, const CatalogSource& source);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    size_t size() const { return m_entryCount; }
+    const CatalogEntry& entryAt(size_t index) const { return m_entries[index]; }
+
+    // nullptr if absent; O(log n) over the mapped index.
+    const CatalogEntry* findByID(int32_t levelID) const;
+    const CatalogEntry* findByName(std::string_view name) const;
+
+    std::string_view nameOf(const CatalogEntry& entry) const;
+    // Points into the mapping; stays valid until close().
+    std::string_view levelDataOf(const CatalogEntry& entry) const;
+
+    // Builds a catalog file (temp file, fsync, rename, so neither readers
+    // nor a crash ever leave a partial one in place). Records only point at
+    // the name and data, typically into the catalog being replaced (which
+    // stays mapped until reopened) or a loaded GJGameLevel, so writing never
+    // holds a second copy of every level in memory.
+    struct LevelRecord {
+        CatalogLevelInfo info;
+        std::string_view name;
+        std::string_view compressedData;
+    };
+    static bool write(const std::string& path, std::vector<LevelRecord> levels, const CatalogSource& source);
+
+private:
+    MappedFile m_file;
+    const CatalogEntry* m_entries = nullptr;
+    const uint32_t* m_nameOrder = nullptr;
+    size_t m_entryCount = 0;
+};
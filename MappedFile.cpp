@@ -0,0 +1,70 @@
+// MappedFile.cpp
+#include "MappedFile.hpp"
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(other.m_data), m_size(other.m_size) {
+    other.m_data = nullptr;
+    other.m_size = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_data = other.m_data;
+        m_size = other.m_size;
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* mapping = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // the mapping keeps the file alive
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    m_data = static_cast<const uint8_t*>(mapping);
+    m_size = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data) {
+        ::munmap(const_cast<uint8_t*>(m_data), m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
+
+void MappedFile::willNeed(size_t offset, size_t length) const {
+    if (!m_data || offset >= m_size) {
+        return;
+    }
+    // madvise wants a page-aligned start
+    size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t alignedOffset = offset - (offset % pageSize);
+    size_t end = std::min(offset + length, m_size);
+    ::madvise(const_cast<uint8_t*>(m_data) + alignedOffset, end - alignedOffset, MADV_WILLNEED);
+}
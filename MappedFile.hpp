@@ -0,0 +1,37 @@
+#pragma once
+
+#include "main.hpp"
+
+// ==============================================
+// READ-ONLY MEMORY-MAPPED FILE
+// ==============================================
+//
+// Maps a whole file read-only (mmap, MAP_PRIVATE). Pages are read in by the
+// kernel on first touch and can be dropped again under memory pressure, so
+// only the parts of the file that are actually read count as resident.
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // False if the file is missing, empty or can't be mapped.
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+    // Hints that [offset, offset + length) will be read soon.
+    void willNeed(size_t offset, size_t length) const;
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+};
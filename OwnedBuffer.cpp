@@ -0,0 +1,109 @@
+// OwnedBuffer.cpp
+#include "OwnedBuffer.hpp"
+
+namespace {
+// Single shared empty string, handed out by every Empty handle so callers
+// can always read c_str() without a null check.
+const char g_sharedEmptyString[1] = {'\0'};
+}
+
+const char* sharedEmptyString() noexcept {
+    return g_sharedEmptyString;
+}
+
+void OwnedString::assign(const char* str, size_t length) {
+    if (!str || length == 0) {
+        reset();
+        return;
+    }
+
+    // Reuse an existing heap block if it is already large enough.
+    if (m_tag == BufferOwnership::Heap && length <= m_size) {
+        std::memmove(m_heap, str, length);
+        m_heap[length] = '\0';
+        m_size = static_cast<uint32_t>(length);
+        return;
+    }
+
+    if (length <= kInlineCapacity) {
+        // Copy first in case str points into our own heap block.
+        char scratch[kInlineCapacity + 1];
+        std::memcpy(scratch, str, length);
+        reset();
+        std::memcpy(m_inline, scratch, length);
+        m_inline[length] = '\0';
+        m_tag = BufferOwnership::Inline;
+    } else {
+        char* block = new char[length + 1];
+        std::memcpy(block, str, length);
+        block[length] = '\0';
+        reset();
+        m_heap = block;
+        m_tag = BufferOwnership::Heap;
+    }
+    m_size = static_cast<uint32_t>(length);
+}
+
+void OwnedString::assign(const char* str, size_t length, ObjectBufferArena& arena) {
+    if (!str || length <= kInlineCapacity) {
+        assign(str, length);
+        return;
+    }
+
+    char* block = static_cast<char*>(arena.allocate(length + 1, 1));
+    std::memcpy(block, str, length);
+    block[length] = '\0';
+    reset();
+    m_heap = block;
+    m_tag = BufferOwnership::Arena;
+    m_size = static_cast<uint32_t>(length);
+}
+
+void OwnedString::reset() noexcept {
+    if (m_tag == BufferOwnership::Heap) {
+        delete[] m_heap;
+    }
+    m_tag = BufferOwnership::Empty;
+    m_size = 0;
+}
+
+// ==============================================
+// ObjectBufferArena
+// ==============================================
+
+ObjectBufferArena* ObjectBufferArena::create(size_t blockSize) {
+    return new ObjectBufferArena(blockSize);
+}
+
+ObjectBufferArena::~ObjectBufferArena() {
+    for (char* block : m_blocks) {
+        delete[] block;
+    }
+}
+
+void* ObjectBufferArena::allocate(size_t bytes, size_t alignment) {
+    // Requests that don't fit an empty block get one of their own; the
+    // current block keeps its cursor and remaining space.
+    if (bytes + alignment > m_blockSize) {
+        char* block = new char[bytes + alignment];
+        m_blocks.push_back(block);
+        m_bytesUsed += bytes;
+        size_t padding = (alignment - (uintptr_t(block) & (alignment - 1))) & (alignment - 1);
+        return block + padding;
+    }
+
+    size_t padding = (alignment - (uintptr_t(m_cursor) & (alignment - 1))) & (alignment - 1);
+    if (!m_cursor || padding + bytes > m_remaining) {
+        char* block = new char[m_blockSize];
+        m_blocks.push_back(block);
+        m_cursor = block;
+        m_remaining = m_blockSize;
+        padding = (alignment - (uintptr_t(m_cursor) & (alignment - 1))) & (alignment - 1);
+    }
+
+    char* result = m_cursor + padding;
+    m_cursor = result + bytes;
+    m_remaining -= padding + bytes;
+    m_bytesUsed += bytes;
+    return result;
+}
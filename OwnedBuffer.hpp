@@ -0,0 +1,241 @@
+#pragma once
+
+#include "main.hpp"
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+// ==============================================
+// OWNERSHIP-TAGGED STRING / BUFFER HANDLES
+// ==============================================
+//
+// Replacement for the raw char*/int* fields that GameObject and
+// TextGameObject used to free by hand. The original binary compared every
+// string against the gnustl empty rep (*(CCDirector + 0xfe8)) before calling
+// delete[]; here the ownership is stored in a one-byte tag next to the data,
+// so teardown is a single compare per field.
+//
+// Handles are 24 bytes (16 bytes of data or pointer, size, tag); GameObject
+// documents the resulting member offsets.
+
+enum class BufferOwnership : uint8_t {
+    Empty  = 0, // nothing stored, reads return the shared empty data
+    Inline = 1, // stored in the small buffer inside the handle
+    Heap   = 2, // owned new[] allocation, freed by the handle
+    Arena  = 3, // carved from an ObjectBufferArena, freed with the arena
+};
+
+// Bump allocator shared by all objects of a level. Buffers taken from it are
+// never freed individually; the blocks go in one go with the last reference.
+// Reference counted like a CCObject: the level holds one, and every object
+// with buffers in the arena holds one (GameObject::setParticleString), so an
+// object that outlives the level (still retained by an effect, a batch node
+// being torn down later) never points into freed blocks.
+class ObjectBufferArena {
+public:
+    // Starts with one reference, owned by the caller.
+    static ObjectBufferArena* create(size_t blockSize = 64 * 1024);
+
+    ObjectBufferArena(const ObjectBufferArena&) = delete;
+    ObjectBufferArena& operator=(const ObjectBufferArena&) = delete;
+
+    void retain() noexcept { ++m_references; }
+    void release() noexcept {
+        if (--m_references == 0) delete this;
+    }
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    size_t bytesUsed() const noexcept { return m_bytesUsed; }
+
+private:
+    explicit ObjectBufferArena(size_t blockSize) : m_blockSize(blockSize) {}
+    ~ObjectBufferArena();
+
+    uint32_t m_references = 1;
+    std::vector<char*> m_blocks;
+    char*  m_cursor = nullptr;
+    size_t m_remaining = 0;
+    size_t m_blockSize;
+    size_t m_bytesUsed = 0;
+};
+
+// Shared, immutable empty string (stands in for the gnustl empty rep).
+const char* sharedEmptyString() noexcept;
+
+class OwnedString {
+public:
+    static constexpr size_t kInlineCapacity = 15; // + terminator = 16 bytes
+
+    OwnedString() noexcept = default;
+    explicit OwnedString(const char* str) { assign(str); }
+    OwnedString(const char* str, size_t length) { assign(str, length); }
+
+    OwnedString(const OwnedString& other) { assign(other.c_str(), other.m_size); }
+    OwnedString& operator=(const OwnedString& other) {
+        if (this != &other) {
+            assign(other.c_str(), other.m_size);
+        }
+        return *this;
+    }
+
+    OwnedString(OwnedString&& other) noexcept { steal(other); }
+    OwnedString& operator=(OwnedString&& other) noexcept {
+        if (this != &other) {
+            reset();
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~OwnedString() {
+        if (m_tag == BufferOwnership::Heap) {
+            delete[] m_heap;
+        }
+    }
+
+    void assign(const char* str) { assign(str, str ? std::strlen(str) : 0); }
+    void assign(const char* str, size_t length);
+    void assign(const char* str, size_t length, ObjectBufferArena& arena);
+    void reset() noexcept;
+
+    const char* c_str() const noexcept {
+        switch (m_tag) {
+            case BufferOwnership::Inline: return m_inline;
+            case BufferOwnership::Heap:
+            case BufferOwnership::Arena:  return m_heap;
+            default:                      return sharedEmptyString();
+        }
+    }
+
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+    BufferOwnership ownership() const noexcept { return m_tag; }
+
+private:
+    void steal(OwnedString& other) noexcept {
+        std::memcpy(static_cast<void*>(this), &other, sizeof(OwnedString));
+        other.m_tag = BufferOwnership::Empty;
+        other.m_size = 0;
+    }
+
+    union {
+        char* m_heap;
+        char  m_inline[kInlineCapacity + 1];
+    };
+    uint32_t m_size = 0;
+    BufferOwnership m_tag = BufferOwnership::Empty;
+};
+
+static_assert(sizeof(OwnedString) == 24, "GameObject member offsets assume 24-byte handles");
+
+// Owned array of trivially copyable elements with an inline small buffer.
+// Used for the GameObject particle data arrays (0x478 / 0x488 / 0x498).
+template <typename T, size_t InlineCount = 4>
+class OwnedBuffer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "OwnedBuffer only stores trivially copyable elements");
+
+public:
+    OwnedBuffer() noexcept = default;
+    OwnedBuffer(const T* data, size_t count) { assign(data, count); }
+
+    OwnedBuffer(const OwnedBuffer& other) { assign(other.data(), other.m_count); }
+    OwnedBuffer& operator=(const OwnedBuffer& other) {
+        if (this != &other) {
+            assign(other.data(), other.m_count);
+        }
+        return *this;
+    }
+
+    OwnedBuffer(OwnedBuffer&& other) noexcept { steal(other); }
+    OwnedBuffer& operator=(OwnedBuffer&& other) noexcept {
+        if (this != &other) {
+            reset();
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~OwnedBuffer() {
+        if (m_tag == BufferOwnership::Heap) {
+            delete[] m_heap;
+        }
+    }
+
+    // Resizes to count elements; contents are unspecified afterwards.
+    T* allocate(size_t count) {
+        reset();
+        if (count == 0) {
+            return nullptr;
+        }
+        if (count <= InlineCount) {
+            m_tag = BufferOwnership::Inline;
+        } else {
+            m_heap = new T[count];
+            m_tag = BufferOwnership::Heap;
+        }
+        m_count = static_cast<uint32_t>(count);
+        return data();
+    }
+
+    // Same as allocate(), but large buffers come from the level arena.
+    T* allocate(size_t count, ObjectBufferArena& arena) {
+        if (count <= InlineCount) {
+            return allocate(count);
+        }
+        reset();
+        m_heap = static_cast<T*>(arena.allocate(count * sizeof(T), alignof(T)));
+        m_tag = BufferOwnership::Arena;
+        m_count = static_cast<uint32_t>(count);
+        return m_heap;
+    }
+
+    void assign(const T* source, size_t count) {
+        T* dest = allocate(count);
+        if (dest && source) {
+            std::memcpy(dest, source, count * sizeof(T));
+        }
+    }
+
+    void reset() noexcept {
+        if (m_tag == BufferOwnership::Heap) {
+            delete[] m_heap;
+        }
+        m_tag = BufferOwnership::Empty;
+        m_count = 0;
+    }
+
+    T* data() noexcept {
+        switch (m_tag) {
+            case BufferOwnership::Inline: return m_inline;
+            case BufferOwnership::Heap:
+            case BufferOwnership::Arena:  return m_heap;
+            default:                      return nullptr;
+        }
+    }
+    const T* data() const noexcept { return const_cast<OwnedBuffer*>(this)->data(); }
+
+    T& operator[](size_t index) noexcept { return data()[index]; }
+    const T& operator[](size_t index) const noexcept { return data()[index]; }
+
+    size_t size() const noexcept { return m_count; }
+    bool empty() const noexcept { return m_count == 0; }
+    BufferOwnership ownership() const noexcept { return m_tag; }
+
+private:
+    void steal(OwnedBuffer& other) noexcept {
+        std::memcpy(static_cast<void*>(this), &other, sizeof(OwnedBuffer));
+        other.m_tag = BufferOwnership::Empty;
+        other.m_count = 0;
+    }
+
+    union {
+        T* m_heap;
+        T  m_inline[InlineCount];
+    };
+    uint32_t m_count = 0;
+    BufferOwnership m_tag = BufferOwnership::Empty;
+};
+
+static_assert(sizeof(OwnedBuffer<int>) == 24, "GameObject member offsets assume 24-byte handles");
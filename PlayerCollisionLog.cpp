@@ -0,0 +1,41 @@
+// PlayerCollisionLog.cpp
+#include "PlayerCollisionLog.hpp"
+
+#include <algorithm>
+
+void PlayerCollisionLog::resize(size_t objectCount) {
+    m_stamps.assign(objectCount, 0);
+    m_kindMasks.assign(objectCount, 0);
+    m_count = 0;
+    m_generation = 1;
+    m_overflowCount = 0;
+}
+
+bool PlayerCollisionLog::add(const CollisionContact& contact) {
+    uint32_t index = contact.objectIndex;
+    bool tracked = index < m_stamps.size();
+    if (tracked && contains(index, contact.kind)) {
+        return false;
+    }
+
+    if (m_count == kCapacity) {
+        ++m_overflowCount;
+        return false;
+    }
+
+    if (tracked) {
+        if (m_stamps[index] != m_generation) {
+            m_stamps[index] = m_generation;
+            m_kindMasks[index] = 0;
+        }
+        m_kindMasks[index] |= kindBit(contact.kind);
+    }
+    m_contacts[m_count++] = contact;
+    return true;
+}
+
+void PlayerCollisionLog::resetStamps() {
+    // Generation wrapped after 2^32 ticks; start over with clean stamps.
+    std::fill(m_stamps.begin(), m_stamps.end(), 0);
+    m_generation = 1;
+}
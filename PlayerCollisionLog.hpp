@@ -0,0 +1,82 @@
+#pragma once
+
+#include "main.hpp"
+
+// ==============================================
+// FRAME-SCOPED PLAYER COLLISION LOG
+// ==============================================
+//
+// Replaces PlayerObject's m_collisionLog dictionary and the m_touchingObjects /
+// m_slopeObjects CCArrays. Contacts are stored by collision index (the slot
+// GJBaseGameLayer::buildCollisionBroadPhase gives each object) in a fixed
+// array, so logging never retains/releases and never allocates.
+//
+// clear() is O(1): the contact count drops to zero and the generation counter
+// moves on, which invalidates every per-object "already logged" stamp at once.
+// Iteration is in the order contacts were added.
+
+enum class CollisionContactKind : uint8_t {
+    Solid,   // collidedWithObject
+    Touch,   // touchedObject (orbs, pads, portals)
+    Slope,   // preSlopeCollision
+};
+
+struct CollisionContact {
+    uint32_t objectIndex;
+    float    yDelta;
+    float    contactY;      // surface height the player was resolved against
+    CollisionContactKind kind;
+    bool     fromTop;
+};
+
+class PlayerCollisionLog {
+public:
+    static constexpr size_t kCapacity = 64;
+
+    // Sizes the per-object stamp table; call at level load, not per tick.
+    void resize(size_t objectCount);
+
+    void clear() {
+        m_count = 0;
+        if (++m_generation == 0) {
+            resetStamps();
+        }
+    }
+
+    // Returns false if the object is already logged with this kind this
+    // tick, or the log is full.
+    bool add(const CollisionContact& contact);
+
+    bool contains(uint32_t objectIndex, CollisionContactKind kind) const {
+        return objectIndex < m_stamps.size() && m_stamps[objectIndex] == m_generation &&
+               (m_kindMasks[objectIndex] & kindBit(kind)) != 0;
+    }
+
+    size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    const CollisionContact* begin() const { return m_contacts; }
+    const CollisionContact* end() const { return m_contacts + m_count; }
+
+    template <typename Fn>
+    void forEach(CollisionContactKind kind, Fn&& fn) const {
+        for (size_t i = 0; i < m_count; ++i) {
+            if (m_contacts[i].kind == kind) fn(m_contacts[i]);
+        }
+    }
+
+    // Contacts dropped because the log was full (should stay 0 in practice).
+    uint32_t overflowCount() const { return m_overflowCount; }
+
+private:
+    static uint8_t kindBit(CollisionContactKind kind) {
+        return static_cast<uint8_t>(1u << static_cast<uint8_t>(kind));
+    }
+    void resetStamps();
+
+    CollisionContact m_contacts[kCapacity];
+    size_t   m_count = 0;
+    uint32_t m_generation = 1;
+    uint32_t m_overflowCount = 0;
+    std::vector<uint32_t> m_stamps;    // generation the object was last logged in
+    std::vector<uint8_t>  m_kindMasks; // kinds logged, valid while the stamp is current
+};
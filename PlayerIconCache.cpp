@@ -0,0 +1,169 @@
+// PlayerIconCache.cpp
+#include "PlayerIconCache.hpp"
+#include "GameManager.h"
+
+using namespace cocos2d;
+
+namespace {
+PlayerIconCache* s_sharedCache = nullptr;
+}
+
+PlayerIconCache* PlayerIconCache::sharedCache() {
+    if (!s_sharedCache) {
+        s_sharedCache = new PlayerIconCache();
+    }
+    return s_sharedCache;
+}
+
+// ============================================================================
+// Refcounting
+// ============================================================================
+
+void PlayerIconCache::load(uint32_t packed, Entry& entry) {
+    PlayerIconKey key = PlayerIconKey::unpack(packed);
+    GameManager::sharedState()->loadIcon(key.iconID, static_cast<int>(key.type), kRequestID);
+    entry.loaded = true;
+}
+
+void PlayerIconCache::unload(uint32_t packed, Entry& entry) {
+    PlayerIconKey key = PlayerIconKey::unpack(packed);
+    GameManager::sharedState()->unloadIcon(key.iconID, static_cast<int>(key.type), kRequestID);
+    entry.loaded = false;
+}
+
+void PlayerIconCache::acquire(const PlayerIconKey& key) {
+    uint32_t packed = key.packed();
+    Entry& entry = m_entries[packed];
+    ++entry.refCount;
+    if (entry.idle) {
+        entry.idle = false;  // its slot in m_idle goes stale
+        --m_idleCount;
+    }
+
+    if (!entry.loaded) {
+        // A queued preload still completes later; load() is idempotent
+        load(packed, entry);
+    }
+}
+
+void PlayerIconCache::release(const PlayerIconKey& key) {
+    auto it = m_entries.find(key.packed());
+    if (it == m_entries.end() || it->second.refCount == 0) {
+        return;
+    }
+    if (--it->second.refCount == 0) {
+        park(it->first, it->second);
+    }
+}
+
+void PlayerIconCache::park(uint32_t packed, Entry& entry) {
+    entry.idle = true;
+    ++m_idleCount;
+    m_idle.push_back(packed);
+    trimIdle(m_idleLimit);
+}
+
+void PlayerIconCache::trimIdle(size_t limit) {
+    while (!m_idle.empty()) {
+        auto it = m_entries.find(m_idle.front());
+        bool stale = it == m_entries.end() || !it->second.idle;
+        if (!stale && m_idleCount <= limit) {
+            break;
+        }
+        m_idle.pop_front();
+        if (stale) {
+            continue;  // re-acquired (and maybe re-parked) since it was queued
+        }
+
+        Entry& entry = it->second;
+        entry.idle = false;
+        --m_idleCount;
+        if (entry.loaded) {
+            unload(it->first, entry);
+        }
+        if (!entry.loading) {
+            m_entries.erase(it);
+        }
+    }
+}
+
+void PlayerIconCache::purgeUnused() {
+    trimIdle(0);
+}
+
+void PlayerIconCache::setIdleLimit(size_t limit) {
+    m_idleLimit = limit;
+    trimIdle(m_idleLimit);
+}
+
+bool PlayerIconCache::isLoaded(const PlayerIconKey& key) const {
+    auto it = m_entries.find(key.packed());
+    return it != m_entries.end() && it->second.loaded;
+}
+
+int PlayerIconCache::refCount(const PlayerIconKey& key) const {
+    auto it = m_entries.find(key.packed());
+    return it != m_entries.end() ? it->second.refCount : 0;
+}
+
+// ============================================================================
+// Background preload
+// ============================================================================
+
+void PlayerIconCache::preload(const std::vector<PlayerIconKey>& keys) {
+    GameManager* gm = GameManager::sharedState();
+    CCTextureCache* textures = CCTextureCache::sharedTextureCache();
+
+    for (const PlayerIconKey& key : keys) {
+        uint32_t packed = key.packed();
+        Entry& entry = m_entries[packed];
+        if (entry.loaded || entry.loading) {
+            continue;
+        }
+
+        entry.loading = true;
+        m_preloadQueue.push_back(packed);
+
+        // Only the PNG decode happens off-thread; the plist and sprite
+        // frames are registered by loadIcon() in onPreloadTexture.
+        std::string sheet = gm->sheetNameForIcon(key.iconID, static_cast<int>(key.type));
+        textures->addImageAsync((sheet + ".png").c_str(), this,
+                                callfuncO_selector(PlayerIconCache::onPreloadTexture));
+    }
+}
+
+void PlayerIconCache::onPreloadTexture(CCObject* /*texture*/) {
+    // Main thread. CCTextureCache has a single loader thread and reports
+    // completions in submission order.
+    if (m_preloadQueue.empty()) {
+        return;
+    }
+    uint32_t packed = m_preloadQueue.front();
+    m_preloadQueue.pop_front();
+
+    Entry& entry = m_entries[packed];
+    entry.loading = false;
+    if (!entry.loaded) {
+        load(packed, entry);  // texture is resident now, this is cheap
+    }
+
+    // Nobody asked for it yet: park it so it's unloaded lazily if unused
+    if (entry.refCount == 0 && !entry.idle) {
+        park(packed, entry);
+    }
+}
+
+// ============================================================================
+// Colors
+// ============================================================================
+
+ccColor3B PlayerIconCache::colorForIdx(int index) {
+    if (index < 0 || index >= kColorCount) {
+        return GameManager::colorForIdx(index);
+    }
+    if (!m_colorResolved[index]) {
+        m_colors[index] = GameManager::colorForIdx(index);
+        m_colorResolved[index] = true;
+    }
+    return m_colors[index];
+}
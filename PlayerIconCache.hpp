@@ -0,0 +1,108 @@
+#pragma once
+
+#include "main.hpp"
+#include <cocos2d.h>
+
+#include <bitset>
+#include <deque>
+
+// ==============================================
+// SHARED PLAYER ICON / COLOR CACHE
+// ==============================================
+//
+// createPlayer used to resolve every player color through
+// GameManager::colorForIdx and recompute the icon IDs per player, and each
+// SimplePlayer loaded its icon sheet under its own request ID and dropped it
+// again with GameManager::unloadIcons in its destructor, so a leaderboard
+// with a hundred rows loaded and unloaded the same sheets over and over.
+//
+// The cache loads each icon sheet once under a single request ID and
+// refcounts it across every PlayerObject and SimplePlayer that shows it.
+// When the last user releases an icon it is parked on an idle list and only
+// unloaded when the list grows past the idle limit or on purgeUnused(), so
+// scrolling a list back and forth doesn't thrash the texture cache.
+//
+// Menus that show many icons (icon kit, leaderboards) call preload() up
+// front: the sheets are decoded on CCTextureCache's loader thread and
+// registered on the main thread as they arrive.
+//
+// Player colors are a static table; each index is resolved once.
+
+enum class PlayerIconType : uint8_t {
+    Cube = 0,
+    Ship = 1,
+    Ball = 2,
+    Ufo = 3,
+    Wave = 4,
+    Robot = 5,
+    Spider = 6,
+    Swing = 7,
+};
+
+struct PlayerIconKey {
+    int32_t iconID;
+    PlayerIconType type;
+
+    uint32_t packed() const {
+        return (static_cast<uint32_t>(type) << 16) | (static_cast<uint32_t>(iconID) & 0xffff);
+    }
+    static PlayerIconKey unpack(uint32_t packed) {
+        return {static_cast<int32_t>(packed & 0xffff), static_cast<PlayerIconType>(packed >> 16)};
+    }
+};
+
+class PlayerIconCache : public cocos2d::CCObject {
+public:
+    // Request ID the cache loads every icon under (GameManager's per-requester
+    // bookkeeping sees one user no matter how many players share a sheet).
+    static constexpr int kRequestID = 0x1c0;
+    static constexpr size_t kDefaultIdleLimit = 32;
+    static constexpr int kColorCount = 256;
+
+    static PlayerIconCache* sharedCache();
+
+    // Loads the sheet synchronously if it isn't resident yet.
+    void acquire(const PlayerIconKey& key);
+    void release(const PlayerIconKey& key);
+
+    // Starts async loads for sheets that aren't resident or already queued.
+    void preload(const std::vector<PlayerIconKey>& keys);
+    size_t pendingPreloads() const { return m_preloadQueue.size(); }
+
+    // Unloads every icon nobody holds (scene change, memory warning).
+    void purgeUnused();
+
+    // Icon kit raises this while open so preloaded sheets aren't evicted
+    // before their cells are built.
+    void setIdleLimit(size_t limit);
+
+    bool isLoaded(const PlayerIconKey& key) const;
+    int refCount(const PlayerIconKey& key) const;
+
+    cocos2d::ccColor3B colorForIdx(int index);
+
+private:
+    struct Entry {
+        int  refCount = 0;
+        bool loaded = false;
+        bool loading = false;
+        bool idle = false;
+    };
+
+    PlayerIconCache() = default;
+
+    void load(uint32_t packed, Entry& entry);
+    void unload(uint32_t packed, Entry& entry);
+    void park(uint32_t packed, Entry& entry);
+    void trimIdle(size_t limit);
+    void onPreloadTexture(cocos2d::CCObject* texture);
+
+    std::unordered_map<uint32_t, Entry> m_entries;
+    std::deque<uint32_t> m_idle;          // oldest first; may hold stale keys
+    size_t m_idleCount = 0;               // entries currently parked
+    std::deque<uint32_t> m_preloadQueue;  // CCTextureCache completes in order
+    size_t m_idleLimit = kDefaultIdleLimit;
+
+    cocos2d::ccColor3B m_colors[kColorCount];
+    std::bitset<kColorCount> m_colorResolved;
+};
@@ -1,28 +1,67 @@
 // PlayerObject.cpp
 #include "PlayerObject.hpp"
 #include "GameManager.hpp"
-
+#include "PlayerPhysicsStepper.hpp"
+#include "PlayerReplay.hpp"
+#include "PlayerCollisionLog.hpp"
+#include "SlopeSolver.hpp"
+#include "PlayerParticleManager.hpp"
+#include "PlayerIconCache.hpp"
+
+// GameObject and the members with constructors (stepper, collision log,
+// the particle handles) are already initialised by the time this body runs;
+// the memset of the whole object this replaces wiped them, vtable pointer
+// included. Only the plain fields are set here.
 PlayerObject::PlayerObject() {
-    // Initialize all members to zero/false
-    memset(reinterpret_cast<void*>(this), 0, sizeof(PlayerObject));
+    m_playerSprite = nullptr;
+    m_streak = nullptr;
+    m_checkpointData = nullptr;
+    m_replayRecorder = nullptr;
+    m_replayPlayer = nullptr;
+    m_replayCursor = 0;
+
+    m_yVelocity = 0.0;
+    m_gravity = 1;
+    m_lastSafeY = 0.0f;
+    m_unknown384 = 0;
+    m_isUpsideDown = false;
+    m_isOnGround = false;
+    m_isFlying = false;
+    m_isDashing = false;
+    m_isShip = false;
+    m_isBall = false;
+    m_isSpider = false;
+    m_isSwing = false;
+    m_isPlatformer = false;
+    m_controlsLocked = false;
+    m_hasJustJumped = false;
+
+    // No slope chain yet; slope indices start at 0, so 0 would name one
+    m_slopeSolver = nullptr;
+    m_currentSlope = -1;
+
+    m_cubeIconID = 0;
+    m_shipIconID = 0;
+    m_hasIconRefs = false;
+
+    // The stepper carries non-zero defaults (gravity, terminal velocity)
+    m_physicsStepper.reset(PlayerPhysicsState());
+    m_physicsStepper.setInputHandler(&PlayerObject::onTimedInput, this);
 }
 
+// ~GameObject runs after this body, as for any base class; calling it here
+// as well destroyed the particle handles twice.
 PlayerObject::~PlayerObject() {
-    // Call base destructor first
-    GameObject::~GameObject();
-
-    // Release owned arrays
-    if (m_slopeObjects) {
-        m_slopeObjects->release();
-        m_slopeObjects = nullptr;
-    }
-    if (m_touchingObjects) {
-        m_touchingObjects->release();
-        m_touchingObjects = nullptr;
-    }
-    if (m_activeParticles) {
-        m_activeParticles->release();
-        m_activeParticles = nullptr;
+    // Touching/slope objects live in m_collisionLog; emitters go back to the
+    // shared particle pool instead of being released with m_activeParticles
+    PlayerParticleManager::sharedManager()->releaseAllFor(this);
+    m_streak = nullptr;
+
+    // Drop the icon sheet references taken in create()
+    if (m_hasIconRefs) {
+        PlayerIconCache* icons = PlayerIconCache::sharedCache();
+        icons->release({m_cubeIconID, PlayerIconType::Cube});
+        icons->release({m_shipIconID, PlayerIconType::Ship});
     }
 
     // Delete checkpoint data if not globally managed
@@ -35,7 +74,20 @@ PlayerObject::~PlayerObject() {
 
 PlayerObject* PlayerObject::create(int playerID, int iconID, GJBaseGameLayer* layer, cocos2d::CCLayer* camera, bool isDual) {
     auto* player = new PlayerObject();
-    if (player && player->init(playerID, iconID, layer, camera, isDual)) {
+    if (!player) {
+        return nullptr;
+    }
+
+    // Resident before init() builds the sprites, shared with the other player
+    // and any SimplePlayer showing the same icons
+    PlayerIconCache* icons = PlayerIconCache::sharedCache();
+    icons->acquire({playerID, PlayerIconType::Cube});
+    icons->acquire({iconID, PlayerIconType::Ship});
+    player->m_cubeIconID = playerID;
+    player->m_shipIconID = iconID;
+    player->m_hasIconRefs = true;
+
+    if (player->init(playerID, iconID, layer, camera, isDual)) {
         player->autorelease();
         return player;
     }
@@ -43,6 +95,64 @@ PlayerObject* PlayerObject::create(int playerID, int iconID, GJBaseGameLayer* la
     return nullptr;
 }
 
+// Level restart: back to the state create() + createPlayer left the player
+// in, without rebuilding sprites, icon references or emitters.
+void PlayerObject::reset(const cocos2d::CCPoint& startPosition) {
+    stopAllActions();
+    if (m_playerSprite) {
+        m_playerSprite->stopAllActions();
+        m_playerSprite->setRotation(0.0f);
+    }
+    setRotation(0.0f);
+    setVisible(true);
+    setPosition(startPosition);
+
+    // Physics: fresh stepper state (tick 0, empty input queue)
+    PlayerPhysicsState initial;
+    initial.x = startPosition.x;
+    initial.y = startPosition.y;
+    m_physicsStepper.reset(initial);
+    m_yVelocity = 0.0;
+    m_gravity = 1;
+    m_isUpsideDown = false;
+    m_isOnGround = true;
+    m_isFlying = false;
+    m_isDashing = false;
+    m_isShip = false;
+    m_isBall = false;
+    m_isSpider = false;
+    m_isSwing = false;
+    m_lastSafeY = startPosition.y;
+
+    // Recorded and replayed ticks restart with the stepper
+    if (m_replayRecorder) {
+        m_replayRecorder->restart();
+    }
+    m_replayCursor = 0;
+
+    m_controlsLocked = false;
+    m_hasJustJumped = false;
+
+    m_currentSlope = -1;
+    m_collisionLog.clear();
+
+    // Emitters stay attached to their batch nodes; only their particles go.
+    // resetAllFor may send a stopping streak back to the pool, where another
+    // player can take it, so the streak is handed back and re-acquired
+    // (usually the same system, straight from the pool).
+    PlayerParticleManager* particles = PlayerParticleManager::sharedManager();
+    if (m_streak) {
+        particles->deactivate(m_streak);
+        m_streak = nullptr;
+    }
+    particles->resetAllFor(this);
+    setupStreak();
+    if (m_streak) {
+        m_streak->setPosition(startPosition);
+        m_streak->resetSystem();
+    }
+}
+
 // --- Core Methods (Representative Samples) ---
 
 void PlayerObject::bumpPlayer(float yVel, int type, bool force, GameObject* obj) {
@@ -60,11 +170,14 @@ void PlayerObject::bumpPlayer(float yVel, int type, bool force, GameObject* obj)
     setYVelocity(yVel);
 }
 
+// Orbs fire while the jump button is held, the same rule
+// HeadlessLevelSimulator applies.
 void PlayerObject::ringJump(GameObject* obj) {
-    if (m_isFlying) return;
     if (m_isDashing) return;
-    setYVelocity(1.0f); // Approximate
+    if (!m_physicsStepper.jumpHeld()) return;
+    setYVelocity(PlayerPhysicsStepper::kOrbVelocity * m_gravity);
     m_isFlying = true;
+    m_physicsStepper.state().isFlying = true;
 }
 
 int PlayerObject::flipMod(int value) {
@@ -83,30 +196,61 @@ bool PlayerObject::isSafeMode() {
     return GameManager::sharedState()->m_safeMode;
 }
 
+// Velocity writes are queued on the stepper and land on the next substep;
+// m_yVelocity mirrors the stepper state after each update.
 void PlayerObject::setYVelocity(double vel) {
-    m_yVelocity = static_cast<float>(vel);
+    m_physicsStepper.setYVelocity(static_cast<float>(vel));
 }
 
 void PlayerObject::addToYVelocity(double delta) {
-    m_yVelocity += static_cast<float>(delta);
+    m_physicsStepper.addToYVelocity(static_cast<float>(delta));
 }
 
+// Like velocity writes, the flip lands on the next substep; m_gravity and
+// m_isUpsideDown follow the stepper in updatePhysics.
 void PlayerObject::flipGravity(PlayerButton dir) {
-    m_gravity = (m_gravity == 1) ? -1 : 1;
-    m_isUpsideDown = !m_isUpsideDown;
+    m_physicsStepper.flipGravity();
+}
+
+// --- Physics Tick ---
+
+// timestampNs is the frame's inputTimestampNow(), read once by the layer
+// for every player.
+void PlayerObject::updatePhysics(float dt, uint64_t timestampNs) {
+    m_physicsStepper.advance(dt, timestampNs);
+
+    const PlayerPhysicsState& state = m_physicsStepper.state();
+    m_yVelocity = state.yVelocity;
+    m_gravity = state.gravityDir;
+    m_isUpsideDown = state.gravityDir == -1;
+    m_isOnGround = state.onGround;
+    m_isFlying = state.isFlying;
+
+    // Draw between the last two substeps so motion stays smooth at any FPS
+    setPositionY(m_physicsStepper.interpolatedState().y);
+
+    // The streak sits in the shared batch node, not under m_playerSprite
+    if (m_streak) {
+        m_streak->setPosition(getPosition());
+    }
 }
 
 // --- Collision Methods ---
 
 void PlayerObject::collidedWithObject(float yDelta, GameObject* obj, const cocos2d::CCRect& rect, bool fromTop) {
     if (obj->m_objectType == 1810) { // Ring
-        ringJump(obj);
+        // Activating a ring changes the ring itself, which the other player
+        // may be touching this frame; GJBaseGameLayer applies it at the join.
+        logContact(obj, CollisionContactKind::Touch, yDelta, rect.getMaxY(), fromTop);
         return;
     }
+    logContact(obj, CollisionContactKind::Solid, yDelta, rect.getMaxY(), fromTop);
     if (fromTop) {
         m_isOnGround = true;
         m_isFlying = false;
-        m_yVelocity = 0;
+        setYVelocity(0.0);
+        m_physicsStepper.state().onGround = true;
+        m_physicsStepper.state().isFlying = false;
     }
 }
 
@@ -114,11 +258,25 @@ void PlayerObject::preSlopeCollision(float yDelta, GameObject* obj) {
     // Handle slope logic
     float slopeY = slopeYPos(obj);
     m_lastSafeY = slopeY;
+    logContact(obj, CollisionContactKind::Slope, yDelta, slopeY, false);
+}
+
+void PlayerObject::logContact(GameObject* obj, CollisionContactKind kind, float yDelta, float contactY, bool fromTop) {
+    // m_collisionIndex is -1 for objects outside the broad-phase; they are
+    // still logged but can't be de-duplicated.
+    int index = obj->m_collisionIndex;
+    m_collisionLog.add({static_cast<uint32_t>(index), yDelta, contactY, kind, fromTop});
 }
 
 float PlayerObject::slopeYPos(GameObject* other) {
-    // Simplified: return average Y of object rect
-    return other->getPositionY();
+    cocos2d::CCRect rect = getObjectRect();
+    float y;
+    if (!m_slopeSolver || !m_slopeSolver->contactHeightFor(static_cast<uint32_t>(other->m_collisionIndex),
+                                                           m_currentSlope, rect.getMinX(), rect.getMaxX(), y)) {
+        // Not part of the loaded level geometry (e.g. spawned mid-level)
+        return other->getPositionY();
+    }
+    return y;
 }
 
 bool PlayerObject::isFacingDown() {
@@ -129,23 +287,95 @@ bool PlayerObject::isFacingDown() {
 
 void PlayerObject::pushButton(PlayerButton button) {
     if (m_controlsLocked) return;
+    recordButton(button, true);
     switch (button) {
         case PlayerButton::Jump:
-            if (!m_isFlying) {
-                setYVelocity(1.0f);
-                m_isFlying = true;
-            }
+            // The jump itself lands on the next substep that starts on the
+            // ground (PlayerPhysicsStepper::setJumpHeld).
+            m_physicsStepper.setJumpHeld(true);
             break;
         default: break;
     }
 }
 
+// Touch/key handlers call this with the capture timestamp instead of calling
+// pushButton/releaseButton directly; the stepper hands the event back through
+// onTimedInput at the substep it happened in.
+void PlayerObject::queueButton(PlayerButton button, bool pressed, uint64_t timestampNs) {
+    m_physicsStepper.queueInput({timestampNs, static_cast<uint8_t>(button), pressed});
+}
+
+void PlayerObject::onTimedInput(void* context, const TimedInput& input) {
+    auto* player = static_cast<PlayerObject*>(context);
+    if (input.pressed) {
+        player->pushButton(static_cast<PlayerButton>(input.button));
+    } else {
+        player->releaseButton(static_cast<PlayerButton>(input.button));
+    }
+}
+
+void PlayerObject::setInputLatencyTracker(InputLatencyTracker* tracker) {
+    m_physicsStepper.setLatencyTracker(tracker);
+}
+
 void PlayerObject::releaseButton(PlayerButton button) {
-    // No-op for jump; handled on press
+    recordButton(button, false);
+    if (button == PlayerButton::Jump) {
+        m_physicsStepper.setJumpHeld(false);
+    }
+}
+
+// --- Replays ---
+
+void PlayerObject::setReplayRecorder(ReplayRecorder* recorder) {
+    m_replayRecorder = recorder;
+}
+
+void PlayerObject::setChecksumWriter(ReplayChecksumWriter* writer) {
+    m_physicsStepper.setTickObserver(writer ? &ReplayChecksumWriter::onStepperTick : nullptr, writer);
+}
+
+// Recorders, checksum writers and latency trackers are usually shared by
+// both players, so they can't be fed from two threads at once.
+bool PlayerObject::needsSerialUpdate() const {
+    return m_replayRecorder || m_physicsStepper.hasObservers();
+}
+
+void PlayerObject::recordButton(PlayerButton button, bool pressed) {
+    if (!m_replayRecorder) return;
+    // m_unknown384 is 1 for player 1 and 2 for player 2 (see createPlayer)
+    uint8_t player = m_unknown384 == 2 ? 1 : 0;
+    m_replayRecorder->record(m_physicsStepper.tick(), player, static_cast<uint8_t>(button), pressed);
+}
+
+// Replay events go in through the stepper at the start of the substep they
+// were recorded on, the same point recordButton took the tick from, however
+// many substeps a frame runs. Each player keeps its own cursor into the
+// shared replay, so both can play from it at once.
+void PlayerObject::setReplayPlayer(ReplayPlayer* replay) {
+    m_replayPlayer = replay;
+    m_replayCursor = 0;
+    m_physicsStepper.setTickInputSource(replay ? &PlayerObject::onReplayTick : nullptr, this);
+}
+
+void PlayerObject::onReplayTick(void* context, uint32_t tick) {
+    auto* player = static_cast<PlayerObject*>(context);
+    const std::vector<ReplayEvent>& events = player->m_replayPlayer->events();
+    uint8_t index = player->m_unknown384 == 2 ? 1 : 0;
+    while (player->m_replayCursor < events.size() && events[player->m_replayCursor].tick <= tick) {
+        const ReplayEvent& event = events[player->m_replayCursor++];
+        if (event.player != index) continue;
+        if (event.pressed) {
+            player->pushButton(static_cast<PlayerButton>(event.button));
+        } else {
+            player->releaseButton(static_cast<PlayerButton>(event.button));
+        }
+    }
 }
 
 void PlayerObject::releaseAllButtons() {
     m_hasJustJumped = false;
+    m_physicsStepper.setJumpHeld(false);
 }
 
 void PlayerObject::enablePlayerControls() {
@@ -168,10 +398,11 @@ void PlayerObject::lockPlayer() {
 
 void PlayerObject::setupStreak() {
     if (!m_streak) {
-        m_streak = cocos2d::CCParticleSystemQuad::create("playerStreak.plist");
+        // Pooled and batched with every other player emitter; the plist is
+        // only parsed the first time any player asks for it.
+        m_streak = PlayerParticleManager::sharedManager()->acquire("playerStreak.plist", this);
         if (m_streak) {
-            m_streak->retain();
-            m_playerSprite->addChild(m_streak);
+            m_streak->setPosition(getPosition());
         }
     }
 }
@@ -189,9 +420,7 @@ void PlayerObject::fadeOutStreak2() {
 }
 
 void PlayerObject::deactivateParticle(cocos2d::CCParticleSystem* particle) {
-    if (particle) {
-        particle->stopSystem();
-    }
+    PlayerParticleManager::sharedManager()->deactivate(particle);
 }
 
 // --- Checkpoints ---
@@ -204,6 +433,13 @@ void PlayerObject::loadFromCheckpoint(void* checkpoint) {
 // --- Utility ---
 
 void PlayerObject::resetCollisionLog() {
+    // O(1): bumps the log generation, no releases or frees
+    // The slope chain only survives a tick if a slope was touched in it.
+    bool touchedSlope = false;
+    m_collisionLog.forEach(CollisionContactKind::Slope, [&](const CollisionContact&) { touchedSlope = true; });
+    if (!touchedSlope) {
+        m_currentSlope = -1;
+    }
     m_collisionLog.clear();
 }
 
@@ -221,5 +457,6 @@ void PlayerObject::showEndAnimation() {
 }
 
 void PlayerObject::touchedObject(GameObject* obj) {
+    logContact(obj, CollisionContactKind::Touch, 0.0f, obj->getPositionY(), false);
     // Handle touch logic (e.g., orbs, pads)
 }
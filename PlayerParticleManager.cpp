@@ -0,0 +1,228 @@
+// PlayerParticleManager.cpp
+#include "PlayerParticleManager.hpp"
+
+using namespace cocos2d;
+
+namespace {
+PlayerParticleManager* s_sharedManager = nullptr;
+
+// Per-template pool cap; emitters beyond this are destroyed on recycle.
+constexpr size_t kMaxPooledPerTemplate = 8;
+}
+
+PlayerParticleManager* PlayerParticleManager::sharedManager() {
+    if (!s_sharedManager) {
+        s_sharedManager = new PlayerParticleManager();
+    }
+    return s_sharedManager;
+}
+
+PlayerParticleManager::~PlayerParticleManager() {
+    purge();
+}
+
+// ============================================================================
+// Layer / batch nodes
+// ============================================================================
+
+void PlayerParticleManager::attachToLayer(CCNode* layer, int zOrder) {
+    detachFromLayer();
+    m_layer = layer;
+    m_zOrder = zOrder;
+    CC_SAFE_RETAIN(m_layer);
+}
+
+void PlayerParticleManager::detachFromLayer() {
+    // Emitters live under the batch nodes, so they go back to the pool first.
+    while (!m_active.empty()) {
+        recycle(m_active.back());
+        m_active.pop_back();
+    }
+    for (auto& entry : m_batchNodes) {
+        entry.second->removeFromParentAndCleanup(true);
+        entry.second->release();
+    }
+    m_batchNodes.clear();
+    CC_SAFE_RELEASE_NULL(m_layer);
+}
+
+CCParticleBatchNode* PlayerParticleManager::batchNodeFor(CCTexture2D* texture) {
+    auto it = m_batchNodes.find(texture);
+    if (it != m_batchNodes.end()) {
+        return it->second;
+    }
+
+    CCParticleBatchNode* batch = CCParticleBatchNode::createWithTexture(texture);
+    batch->retain();
+    if (m_layer) {
+        m_layer->addChild(batch, m_zOrder);
+    }
+    m_batchNodes[texture] = batch;
+    return batch;
+}
+
+// ============================================================================
+// Templates & pooling
+// ============================================================================
+
+CCDictionary* PlayerParticleManager::templateFor(const char* plistName) {
+    auto it = m_templates.find(plistName);
+    if (it != m_templates.end()) {
+        return it->second;
+    }
+
+    // Parsed exactly once per plist for the lifetime of the manager
+    std::string fullPath = CCFileUtils::sharedFileUtils()->fullPathForFilename(plistName);
+    CCDictionary* dict = CCDictionary::createWithContentsOfFileThreadSafe(fullPath.c_str());
+    m_templates[plistName] = dict; // already +1 from the ThreadSafe variant
+    return dict;
+}
+
+CCParticleSystemQuad* PlayerParticleManager::acquire(const char* plistName, PlayerObject* owner) {
+    CCParticleSystemQuad* system = nullptr;
+
+    auto& pool = m_pools[plistName];
+    if (!pool.empty()) {
+        system = pool.back();
+        pool.pop_back();
+        system->resetSystem();
+    } else {
+        CCDictionary* dict = templateFor(plistName);
+        if (!dict) {
+            return nullptr;
+        }
+        system = new CCParticleSystemQuad();
+        if (!system->initWithDictionary(dict)) {
+            system->release();
+            return nullptr;
+        }
+        // Emitters move with the player but their particles stay in the world.
+        system->setPositionType(kCCPositionTypeFree);
+    }
+
+    CCParticleBatchNode* batch = batchNodeFor(system->getTexture());
+    batch->addChild(system);
+
+    m_active.push_back({system, owner, plistName, false, false});
+    return system;
+}
+
+void PlayerParticleManager::deactivate(CCParticleSystem* system) {
+    for (ActiveEmitter& emitter : m_active) {
+        if (emitter.system == system) {
+            emitter.system->stopSystem();
+            emitter.stopping = true;
+            return;
+        }
+    }
+    // Not one of ours (e.g. a level particle); keep the old behaviour.
+    if (system) {
+        system->stopSystem();
+    }
+}
+
+void PlayerParticleManager::releaseAllFor(PlayerObject* owner) {
+    for (size_t i = 0; i < m_active.size();) {
+        if (m_active[i].owner == owner) {
+            recycle(m_active[i]);
+            m_active[i] = m_active.back();
+            m_active.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+void PlayerParticleManager::resetAllFor(PlayerObject* owner) {
+    for (size_t i = 0; i < m_active.size();) {
+        ActiveEmitter& emitter = m_active[i];
+        if (emitter.owner != owner) {
+            ++i;
+            continue;
+        }
+        if (emitter.stopping) {
+            recycle(emitter);
+            m_active[i] = m_active.back();
+            m_active.pop_back();
+            continue;
+        }
+        setCulled(emitter, false);
+        emitter.system->resetSystem();  // drops the live particles
+        emitter.system->stopSystem();
+        ++i;
+    }
+}
+
+void PlayerParticleManager::recycle(ActiveEmitter& emitter) {
+    CCParticleSystemQuad* system = emitter.system;
+    setCulled(emitter, false);
+    system->stopSystem();
+    system->removeFromParentAndCleanup(false);
+
+    auto& pool = m_pools[emitter.plistName];
+    if (pool.size() < kMaxPooledPerTemplate) {
+        pool.push_back(system); // keeps our +1 from acquire()
+    } else {
+        system->release();
+    }
+}
+
+// ============================================================================
+// Per-frame update
+// ============================================================================
+
+void PlayerParticleManager::setCulled(ActiveEmitter& emitter, bool culled) {
+    if (emitter.culled == culled) return;
+    emitter.culled = culled;
+
+    // Unscheduling skips CCParticleSystem::update entirely; the batch node
+    // still owns the quads, they just stop changing.
+    if (culled) {
+        emitter.system->unscheduleUpdate();
+        emitter.system->setVisible(false);
+    } else {
+        emitter.system->scheduleUpdateWithPriority(1);
+        emitter.system->setVisible(true);
+    }
+}
+
+void PlayerParticleManager::update(const CCRect& visibleRect) {
+    for (size_t i = 0; i < m_active.size();) {
+        ActiveEmitter& emitter = m_active[i];
+
+        if (emitter.stopping && emitter.system->getParticleCount() == 0) {
+            recycle(emitter);
+            m_active[i] = m_active.back();
+            m_active.pop_back();
+            continue;
+        }
+
+        if (m_lowDetail) {
+            setCulled(emitter, !visibleRect.containsPoint(emitter.system->getPosition()));
+        }
+        ++i;
+    }
+}
+
+void PlayerParticleManager::setLowDetailMode(bool enabled) {
+    m_lowDetail = enabled;
+    if (!enabled) {
+        for (ActiveEmitter& emitter : m_active) {
+            setCulled(emitter, false);
+        }
+    }
+}
+
+void PlayerParticleManager::purge() {
+    detachFromLayer();
+    for (auto& entry : m_pools) {
+        for (CCParticleSystemQuad* system : entry.second) {
+            system->release();
+        }
+    }
+    m_pools.clear();
+    for (auto& entry : m_templates) {
+        CC_SAFE_RELEASE(entry.second);
+    }
+    m_templates.clear();
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "main.hpp"
+#include <cocos2d.h>
+
+class PlayerObject;
+
+// ==============================================
+// SHARED PLAYER PARTICLE MANAGER
+// ==============================================
+//
+// PlayerObject used to build a CCParticleSystemQuad from "playerStreak.plist"
+// (and the other player plists) per player, re-parsing the plist each time,
+// and kept its emitters in m_activeParticles.
+//
+// The manager parses each plist once into a template dictionary, hands out
+// emitters from a per-template pool, and parents every player emitter that
+// shares a texture under one CCParticleBatchNode, so all of them are drawn
+// from a single vertex buffer. Stopped emitters go back to the pool once
+// their last particle has died.
+//
+// In low-detail mode, emitters that are off-screen are unscheduled, so they
+// are not simulated at all until they come back into view.
+
+class PlayerParticleManager : public cocos2d::CCObject {
+public:
+    static PlayerParticleManager* sharedManager();
+
+    // Parent for the batch nodes; call when the game layer is created.
+    void attachToLayer(cocos2d::CCNode* layer, int zOrder);
+    void detachFromLayer();
+    cocos2d::CCNode* layer() const { return m_layer; }
+
+    // Pooled emitter built from plistName, owned by owner.
+    cocos2d::CCParticleSystemQuad* acquire(const char* plistName, PlayerObject* owner);
+
+    // Stops the emitter; it returns to the pool once it is empty.
+    void deactivate(cocos2d::CCParticleSystem* system);
+
+    // Immediately returns all of owner's emitters to the pool.
+    void releaseAllFor(PlayerObject* owner);
+
+    // Level restart: kills every live particle of owner's emitters and
+    // leaves them stopped but still owned; already-stopping ones go back to
+    // the pool.
+    void resetAllFor(PlayerObject* owner);
+
+    // Called once per frame by the layer: recycles finished emitters and
+    // applies low-detail culling against the visible rect (level space).
+    void update(const cocos2d::CCRect& visibleRect);
+
+    void setLowDetailMode(bool enabled);
+    bool isLowDetailMode() const { return m_lowDetail; }
+
+    // Drops cached templates and pooled emitters (e.g. on memory warning).
+    void purge();
+
+private:
+    struct ActiveEmitter {
+        cocos2d::CCParticleSystemQuad* system;
+        PlayerObject* owner;
+        std::string   plistName;
+        bool stopping;
+        bool culled;
+    };
+
+    PlayerParticleManager() = default;
+    ~PlayerParticleManager() override;
+
+    cocos2d::CCDictionary* templateFor(const char* plistName);
+    cocos2d::CCParticleBatchNode* batchNodeFor(cocos2d::CCTexture2D* texture);
+    void recycle(ActiveEmitter& emitter);
+    void setCulled(ActiveEmitter& emitter, bool culled);
+
+    std::unordered_map<std::string, cocos2d::CCDictionary*> m_templates;
+    std::unordered_map<std::string, std::vector<cocos2d::CCParticleSystemQuad*>> m_pools;
+    std::unordered_map<cocos2d::CCTexture2D*, cocos2d::CCParticleBatchNode*> m_batchNodes;
+    std::vector<ActiveEmitter> m_active;
+
+    cocos2d::CCNode* m_layer = nullptr;
+    int  m_zOrder = 0;
+    bool m_lowDetail = false;
+};
@@ -0,0 +1,223 @@
+// PlayerPhysicsStepper.cpp
+#include "PlayerPhysicsStepper.hpp"
+#include <cstring>
+
+// a*b+c must stay two rounded operations (see the header). GCC ignores
+// #pragma STDC FP_CONTRACT but honours the optimize pragma for every
+// function that follows.
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+PlayerPhysicsStepper::PlayerPhysicsStepper(const PlayerPhysicsState& initial) {
+    reset(initial);
+}
+
+void PlayerPhysicsStepper::reset(const PlayerPhysicsState& initial) {
+    m_state = initial;
+    m_previous = initial;
+    m_hasPendingSet = false;
+    m_pendingSet = 0.0f;
+    m_pendingAdd = 0.0f;
+    m_pendingFlip = false;
+    m_jumpHeld = false;
+    m_accumulator = 0.0f;
+    m_tick = 0;
+    m_inputHead = 0;
+    m_inputCount = 0;
+}
+
+// --- Velocity commands ---
+
+void PlayerPhysicsStepper::setYVelocity(float velocity) {
+    m_hasPendingSet = true;
+    m_pendingSet = velocity;
+    m_pendingAdd = 0.0f;
+}
+
+void PlayerPhysicsStepper::addToYVelocity(float delta) {
+    m_pendingAdd += delta;
+}
+
+void PlayerPhysicsStepper::flipGravity() {
+    m_pendingFlip = !m_pendingFlip;
+}
+
+// --- Stepping ---
+
+int PlayerPhysicsStepper::advance(float frameDelta, uint64_t frameTimeNs) {
+    if (frameDelta > 0.0f) {
+        m_accumulator += frameDelta;
+    }
+
+    // Wall-clock start of the first substep this frame: the accumulator is
+    // exactly the simulated time that is still behind frameTimeNs.
+    const uint64_t substepNs = 1000000000ull / kSubstepsPerSecond;
+    uint64_t backlogNs = static_cast<uint64_t>(static_cast<double>(m_accumulator) * 1e9);
+    uint64_t firstSubstepNs = (frameTimeNs > backlogNs) ? frameTimeNs - backlogNs : 0;
+
+    int steps = 0;
+    while (m_accumulator >= kSubstepDelta && steps < m_maxSubstepsPerFrame) {
+        // Everything captured before this substep ends belongs to it.
+        uint64_t substepEndNs = frameTimeNs ? firstSubstepNs + (steps + 1) * substepNs : UINT64_MAX;
+        deliverInputs(substepEndNs, frameTimeNs);
+
+        step();
+        m_accumulator -= kSubstepDelta;
+        ++steps;
+    }
+
+    // Spiral-of-death guard: drop whatever could not be simulated this frame.
+    if (steps == m_maxSubstepsPerFrame && m_accumulator >= kSubstepDelta) {
+        m_accumulator = 0.0f;
+    }
+    return steps;
+}
+
+// --- Timestamped input ---
+
+void PlayerPhysicsStepper::queueInput(const TimedInput& input) {
+    while (m_inputCount == kInputQueueSize) {
+        // Frame hitch with a burst of taps: apply the oldest event early to
+        // make room, so presses and releases still go out in order.
+        deliverOldestInput(0);
+    }
+    m_inputQueue[(m_inputHead + m_inputCount) % kInputQueueSize] = input;
+    ++m_inputCount;
+}
+
+void PlayerPhysicsStepper::deliverInputs(uint64_t beforeNs, uint64_t frameTimeNs) {
+    while (m_inputCount > 0) {
+        if (m_inputQueue[m_inputHead].timestampNs >= beforeNs) {
+            break; // happened later in the frame (or next frame)
+        }
+        deliverOldestInput(frameTimeNs);
+    }
+}
+
+void PlayerPhysicsStepper::deliverOldestInput(uint64_t frameTimeNs) {
+    // Copied out: the handler may queue another input into this slot.
+    TimedInput input = m_inputQueue[m_inputHead];
+    m_inputHead = (m_inputHead + 1) % kInputQueueSize;
+    --m_inputCount;
+
+    if (m_latencyTracker) {
+        uint64_t now = frameTimeNs ? frameTimeNs : inputTimestampNow();
+        m_latencyTracker->record(now > input.timestampNs ? now - input.timestampNs : 0);
+    }
+    if (m_inputHandler) {
+        m_inputHandler(m_inputHandlerContext, input);
+    }
+}
+
+void PlayerPhysicsStepper::stepTicks(uint32_t ticks) {
+    for (uint32_t i = 0; i < ticks; ++i) {
+        step();
+    }
+}
+
+void PlayerPhysicsStepper::step() {
+    if (m_tickInputSource) {
+        m_tickInputSource(m_tickInputSourceContext, m_tick);
+    }
+    m_previous = m_state;
+    applyPendingCommands();
+    integrate();
+    ++m_tick;
+
+    if (m_tickObserver) {
+        m_tickObserver(m_tickObserverContext, m_state, m_tick);
+    }
+}
+
+void PlayerPhysicsStepper::applyPendingCommands() {
+    if (m_pendingFlip) {
+        m_state.gravityDir = -m_state.gravityDir;
+        m_state.onGround = false;
+        m_pendingFlip = false;
+    }
+    if (m_hasPendingSet) {
+        m_state.yVelocity = m_pendingSet;
+        m_hasPendingSet = false;
+        if (m_pendingSet != 0.0f) {
+            m_state.onGround = false;
+        }
+    }
+    if (m_pendingAdd != 0.0f) {
+        m_state.yVelocity += m_pendingAdd;
+        m_pendingAdd = 0.0f;
+        m_state.onGround = false;
+    }
+    if (m_jumpHeld && m_state.onGround && !m_state.isDashing) {
+        m_state.yVelocity = kJumpVelocity * static_cast<float>(m_state.gravityDir);
+        m_state.onGround = false;
+        m_state.isFlying = true;
+    }
+}
+
+void PlayerPhysicsStepper::integrate() {
+    PlayerPhysicsState& s = m_state;
+
+    if (s.isDashing) {
+        // Dash orbs hold the player on a straight line.
+        s.x += s.xVelocity * kSubstepScale;
+        return;
+    }
+
+    if (!s.onGround) {
+        float gravityStep = s.gravity * kSubstepScale;
+        s.yVelocity -= gravityStep * static_cast<float>(s.gravityDir);
+
+        // Terminal velocity is measured along the gravity direction.
+        float fall = s.yVelocity * static_cast<float>(s.gravityDir);
+        if (fall < -s.terminalVelocity) {
+            s.yVelocity = -s.terminalVelocity * static_cast<float>(s.gravityDir);
+        }
+    }
+
+    s.x += s.xVelocity * kSubstepScale;
+    s.y += s.yVelocity * kSubstepScale;
+
+    // Floor contact, or ceiling contact when upside down.
+    if (s.gravityDir == 1 && s.y <= s.floorY && s.yVelocity <= 0.0f) {
+        s.y = s.floorY;
+        s.yVelocity = 0.0f;
+        s.onGround = true;
+        s.isFlying = false;
+    } else if (s.gravityDir == -1 && s.y >= s.ceilingY && s.yVelocity >= 0.0f) {
+        s.y = s.ceilingY;
+        s.yVelocity = 0.0f;
+        s.onGround = true;
+        s.isFlying = false;
+    }
+}
+
+PlayerPhysicsState PlayerPhysicsStepper::interpolatedState() const {
+    float alpha = interpolationAlpha();
+    float inverse = 1.0f - alpha;
+
+    PlayerPhysicsState blended = m_state;
+    blended.x = m_previous.x * inverse + m_state.x * alpha;
+    blended.y = m_previous.y * inverse + m_state.y * alpha;
+    return blended;
+}
+
+uint64_t hashPlayerState(const PlayerPhysicsState& state, uint64_t seed) {
+    uint32_t words[6];
+    std::memcpy(&words[0], &state.x, sizeof(float));
+    std::memcpy(&words[1], &state.y, sizeof(float));
+    std::memcpy(&words[2], &state.xVelocity, sizeof(float));
+    std::memcpy(&words[3], &state.yVelocity, sizeof(float));
+    words[4] = static_cast<uint32_t>(state.gravityDir);
+    words[5] = (state.onGround ? 1u : 0u) | (state.isFlying ? 2u : 0u) | (state.isDashing ? 4u : 0u);
+
+    uint64_t hash = seed;
+    const auto* bytes = reinterpret_cast<const uint8_t*>(words);
+    for (size_t i = 0; i < sizeof(words); ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "main.hpp"
+#include "InputLatency.hpp"
+
+#include <cfloat>
+
+// ==============================================
+// FIXED-TIMESTEP PLAYER PHYSICS
+// ==============================================
+//
+// PlayerObject used to write m_yVelocity straight from bumpPlayer, ringJump,
+// pushButton and addToYVelocity with no notion of a tick. The stepper owns the
+// vertical physics instead: velocity changes are queued and applied at the
+// start of the next substep, and the simulation always advances in whole
+// 1/240 s substeps (GD's physics rate). Velocities stay in GD's per-1/60 s
+// units, so each substep integrates a quarter of a frame.
+//
+// The stepper does not touch cocos2d at all. PlayerObject syncs its sprite
+// from interpolatedState(); headless callers just call stepTicks().
+//
+// Determinism: everything is float, evaluated in a fixed order, so the same
+// input stream produces bit-identical states on every device. GCC (gnu++
+// modes) and clang both fuse a*b+c into an FMA by default where the target
+// has one, so PlayerPhysicsStepper.cpp turns contraction off with a pragma
+// for each compiler; building it with -ffp-contract=off does the same.
+//
+// The stepper is the authority on gravity: flipGravity() lands on the next
+// substep, and PlayerObject mirrors gravityDir back into m_gravity after
+// each update.
+
+struct PlayerPhysicsState {
+    float x = 0.0f;
+    float y = 105.0f;                // starts on the floor
+    float xVelocity = 0.0f;          // units per 1/60 s
+    float yVelocity = 0.0f;          // units per 1/60 s (PlayerObject::m_yVelocity)
+    float gravity = 0.958199f;       // cube gravity per 1/60 s
+    float terminalVelocity = 15.0f;
+    float floorY = 105.0f;           // ground line in level space
+    float ceilingY = FLT_MAX;        // upside-down ground line (none by default)
+    int   gravityDir = 1;            // PlayerObject::m_gravity (1 or -1)
+    bool  onGround = true;
+    bool  isFlying = false;
+    bool  isDashing = false;
+};
+
+// FNV-1a over the bit patterns of the simulated fields, chained from seed.
+// Used for per-tick checksums and headless final-state hashes.
+uint64_t hashPlayerState(const PlayerPhysicsState& state, uint64_t seed = 0xcbf29ce484222325ull);
+
+class PlayerPhysicsStepper {
+public:
+    static constexpr int   kSubstepsPerSecond = 240;
+    static constexpr float kSubstepDelta = 1.0f / kSubstepsPerSecond;
+    static constexpr float kSubstepScale = 60.0f / kSubstepsPerSecond; // 1/60 s units per substep
+    static constexpr int   kDefaultMaxSubstepsPerFrame = 60;           // 0.25 s catch-up cap
+    static constexpr float kJumpVelocity = 11.180032f;                 // cube jump, units per 1/60 s
+    static constexpr float kOrbVelocity = 11.2f;                       // yellow orb
+
+    PlayerPhysicsStepper() = default;
+    explicit PlayerPhysicsStepper(const PlayerPhysicsState& initial);
+
+    void reset(const PlayerPhysicsState& initial);
+
+    // ===== VELOCITY COMMANDS (applied at the next substep boundary) =====
+    void setYVelocity(float velocity);
+    void addToYVelocity(float delta);
+    void flipGravity();
+
+    // ===== JUMP BUTTON =====
+    // While the button is held, every substep that starts on the ground
+    // begins with a jump (GD's hold-to-jump). PlayerObject::pushButton and
+    // HeadlessLevelSimulator both go through this, so they jump alike.
+    void setJumpHeld(bool held) { m_jumpHeld = held; }
+    bool jumpHeld() const { return m_jumpHeld; }
+
+    // ===== TIMESTAMPED INPUT =====
+    // Inputs wait in a small ring until advance() reaches the substep they
+    // were captured in, then go to the input handler (PlayerObject routes
+    // them to pushButton/releaseButton) right before that substep runs.
+    // When the ring is full the oldest input is handed out immediately to
+    // make room, so events always reach the handler in capture order.
+    static constexpr size_t kInputQueueSize = 32;
+    using InputHandler = void (*)(void* context, const TimedInput& input);
+    void setInputHandler(InputHandler handler, void* context) {
+        m_inputHandler = handler;
+        m_inputHandlerContext = context;
+    }
+    void queueInput(const TimedInput& input);
+    void setLatencyTracker(InputLatencyTracker* tracker) { m_latencyTracker = tracker; }
+
+    // ===== TICK-KEYED INPUT =====
+    // Replays store the substep an input belongs to rather than a capture
+    // time. The source is called at the start of every substep, in advance()
+    // and stepTicks() alike, with the tick about to run and before pending
+    // commands are applied, so whatever it does (pushButton, setJumpHeld)
+    // lands on exactly that substep.
+    using TickInputSource = void (*)(void* context, uint32_t tick);
+    void setTickInputSource(TickInputSource source, void* context) {
+        m_tickInputSource = source;
+        m_tickInputSourceContext = context;
+    }
+
+    // True if a tick observer or latency tracker is attached.
+    bool hasObservers() const { return m_tickObserver || m_latencyTracker; }
+
+    // ===== RENDERED MODE =====
+    // Accumulates frame time and runs as many whole substeps as fit.
+    // frameTimeNs is the inputTimestampNow() at which this frame's physics
+    // runs; with it, queued inputs land on the substep covering their
+    // timestamp. Without it (0) they are all applied at the first substep.
+    // Returns the number of substeps taken.
+    int advance(float frameDelta, uint64_t frameTimeNs = 0);
+
+    // Fraction of a substep left in the accumulator, in [0, 1).
+    float interpolationAlpha() const { return m_accumulator / kSubstepDelta; }
+
+    // Blend between the last two substeps for drawing.
+    PlayerPhysicsState interpolatedState() const;
+
+    void setMaxSubstepsPerFrame(int maxSubsteps) { m_maxSubstepsPerFrame = maxSubsteps; }
+
+    // ===== HEADLESS MODE =====
+    void stepTicks(uint32_t ticks);
+    void step();
+
+    // Called after every substep (e.g. ReplayChecksumWriter::onStepperTick).
+    using TickObserver = void (*)(void* context, const PlayerPhysicsState& state, uint32_t tick);
+    void setTickObserver(TickObserver observer, void* context) {
+        m_tickObserver = observer;
+        m_tickObserverContext = context;
+    }
+
+    const PlayerPhysicsState& state() const { return m_state; }
+    PlayerPhysicsState& state() { return m_state; }
+    const PlayerPhysicsState& previousState() const { return m_previous; }
+    uint32_t tick() const { return m_tick; }
+
+private:
+    void applyPendingCommands();
+    void integrate();
+    void deliverInputs(uint64_t beforeNs, uint64_t frameTimeNs);
+    void deliverOldestInput(uint64_t frameTimeNs);
+
+    PlayerPhysicsState m_state;
+    PlayerPhysicsState m_previous;
+
+    // Pending commands for the next substep. Multiple sets collapse to the
+    // last one; adds are summed on top, matching the old direct writes.
+    bool  m_hasPendingSet = false;
+    float m_pendingSet = 0.0f;
+    float m_pendingAdd = 0.0f;
+    bool  m_pendingFlip = false;
+    bool  m_jumpHeld = false;
+
+    float    m_accumulator = 0.0f;
+    uint32_t m_tick = 0;
+    int      m_maxSubstepsPerFrame = kDefaultMaxSubstepsPerFrame;
+
+    TickObserver m_tickObserver = nullptr;
+    void*        m_tickObserverContext = nullptr;
+
+    TimedInput m_inputQueue[kInputQueueSize];
+    size_t     m_inputHead = 0;
+    size_t     m_inputCount = 0;
+    InputHandler m_inputHandler = nullptr;
+    void*        m_inputHandlerContext = nullptr;
+    TickInputSource m_tickInputSource = nullptr;
+    void*           m_tickInputSourceContext = nullptr;
+    InputLatencyTracker* m_latencyTracker = nullptr;
+};
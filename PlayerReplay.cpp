@@ -0,0 +1,247 @@
+// PlayerReplay.cpp
+#include "PlayerReplay.hpp"
+#include "PlayerPhysicsStepper.hpp"
+#include "HeadlessLevelSimulator.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+const char kReplayMagic[4] = {'G', 'D', 'R', 'P'};
+const char kChecksumMagic[4] = {'G', 'D', 'C', 'S'};
+
+constexpr uint8_t kFlagPlayer2 = 0x80;
+constexpr uint8_t kFlagPressed = 0x40;
+constexpr uint8_t kButtonMask = 0x3f;
+
+// Jump is PlayerButton value 1 in the game's enum.
+constexpr uint8_t kJumpButton = 1;
+
+bool readHeader(FILE* file, const char (&magic)[4], uint16_t expectedVersion) {
+    char fileMagic[4];
+    uint16_t version = 0;
+    if (std::fread(fileMagic, 1, 4, file) != 4 || std::memcmp(fileMagic, magic, 4) != 0) {
+        return false;
+    }
+    if (std::fread(&version, sizeof(version), 1, file) != 1) {
+        return false;
+    }
+    return version == expectedVersion;
+}
+} // namespace
+
+// ==============================================
+// BufferedFileWriter
+// ==============================================
+
+bool BufferedFileWriter::open(const std::string& path) {
+    close();
+    m_file = std::fopen(path.c_str(), "wb");
+    m_used = 0;
+    return m_file != nullptr;
+}
+
+void BufferedFileWriter::close() {
+    if (!m_file) return;
+    flush();
+    std::fclose(m_file);
+    m_file = nullptr;
+}
+
+void BufferedFileWriter::write(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        if (m_used == sizeof(m_buffer)) flush();
+        size_t chunk = std::min(size, sizeof(m_buffer) - m_used);
+        std::memcpy(m_buffer + m_used, bytes, chunk);
+        m_used += chunk;
+        bytes += chunk;
+        size -= chunk;
+    }
+}
+
+void BufferedFileWriter::flush() {
+    if (m_file && m_used > 0) {
+        std::fwrite(m_buffer, 1, m_used, m_file);
+    }
+    m_used = 0;
+}
+
+// ==============================================
+// ReplayRecorder
+// ==============================================
+
+bool ReplayRecorder::open(const std::string& path) {
+    if (!m_writer.open(path)) {
+        return false;
+    }
+    m_writer.write(kReplayMagic, sizeof(kReplayMagic));
+    m_writer.write(&kVersion, sizeof(kVersion));
+    m_path = path;
+    m_lastTick = 0;
+    return true;
+}
+
+void ReplayRecorder::restart() {
+    if (!m_writer.isOpen()) return;
+    std::string path = m_path;
+    open(path); // truncates
+}
+
+void ReplayRecorder::record(uint32_t tick, uint8_t player, uint8_t button, bool pressed) {
+    if (!m_writer.isOpen()) return;
+
+    // Ticks only move forward; a late event is stored at the last tick.
+    uint32_t delta = tick > m_lastTick ? tick - m_lastTick : 0;
+    m_lastTick += delta;
+
+    while (delta >= 0x80) {
+        m_writer.writeByte(static_cast<uint8_t>(delta) | 0x80);
+        delta >>= 7;
+    }
+    m_writer.writeByte(static_cast<uint8_t>(delta));
+
+    uint8_t flags = button & kButtonMask;
+    if (player) flags |= kFlagPlayer2;
+    if (pressed) flags |= kFlagPressed;
+    m_writer.writeByte(flags);
+}
+
+// ==============================================
+// ReplayPlayer
+// ==============================================
+
+bool ReplayPlayer::load(const std::string& path) {
+    m_events.clear();
+    m_cursor = 0;
+
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+
+    if (!readHeader(file, kReplayMagic, ReplayRecorder::kVersion)) {
+        std::fclose(file);
+        return false;
+    }
+
+    // The recorder flushes in 4 KB chunks, so an interrupted run can end in
+    // the middle of a record (varint or flags byte); that partial record is
+    // dropped. An over-long varint is corruption and fails the load.
+    uint32_t tick = 0;
+    int ch;
+    while ((ch = std::fgetc(file)) != EOF) {
+        uint32_t delta = 0;
+        int shift = 0;
+        bool truncated = false;
+        while (ch & 0x80) {
+            delta |= static_cast<uint32_t>(ch & 0x7f) << shift;
+            shift += 7;
+            if (shift > 28) {
+                std::fclose(file);
+                return false;
+            }
+            ch = std::fgetc(file);
+            if (ch == EOF) {
+                truncated = true;
+                break;
+            }
+        }
+        if (truncated) break;
+        delta |= static_cast<uint32_t>(ch) << shift;
+
+        int flags = std::fgetc(file);
+        if (flags == EOF) break;
+
+        tick += delta;
+        m_events.push_back({tick,
+                            static_cast<uint8_t>((flags & kFlagPlayer2) ? 1 : 0),
+                            static_cast<uint8_t>(flags & kButtonMask),
+                            (flags & kFlagPressed) != 0});
+    }
+
+    std::fclose(file);
+    return true;
+}
+
+std::pair<size_t, size_t> ReplayPlayer::eventsUntil(uint32_t tick) {
+    size_t begin = m_cursor;
+    while (m_cursor < m_events.size() && m_events[m_cursor].tick <= tick) {
+        ++m_cursor;
+    }
+    return {begin, m_cursor};
+}
+
+std::vector<HeadlessInputEvent> ReplayPlayer::toHeadlessInputs() const {
+    std::vector<HeadlessInputEvent> inputs;
+    inputs.reserve(m_events.size());
+    for (const ReplayEvent& event : m_events) {
+        if (event.button == kJumpButton) {
+            inputs.push_back({event.tick, event.player, event.pressed});
+        }
+    }
+    return inputs;
+}
+
+// ==============================================
+// Checksums
+// ==============================================
+
+bool ReplayChecksumWriter::open(const std::string& path) {
+    if (!m_writer.open(path)) {
+        return false;
+    }
+    m_writer.write(kChecksumMagic, sizeof(kChecksumMagic));
+    m_writer.write(&kVersion, sizeof(kVersion));
+    return true;
+}
+
+void ReplayChecksumWriter::onStepperTick(void* context, const PlayerPhysicsState& state, uint32_t) {
+    static_cast<ReplayChecksumWriter*>(context)->writeTick(state);
+}
+
+void ReplayChecksumWriter::writeTick(const PlayerPhysicsState& state) {
+    uint32_t checksum = static_cast<uint32_t>(hashPlayerState(state));
+    m_writer.write(&checksum, sizeof(checksum));
+}
+
+int64_t findFirstDivergence(const std::string& checksumPathA, const std::string& checksumPathB) {
+    FILE* a = std::fopen(checksumPathA.c_str(), "rb");
+    FILE* b = std::fopen(checksumPathB.c_str(), "rb");
+    int64_t divergence = kChecksumReadError;
+
+    if (a && b &&
+        readHeader(a, kChecksumMagic, ReplayChecksumWriter::kVersion) &&
+        readHeader(b, kChecksumMagic, ReplayChecksumWriter::kVersion)) {
+        uint32_t bufferA[1024];
+        uint32_t bufferB[1024];
+        int64_t tick = 0;
+        divergence = kChecksumsMatch;
+        for (;;) {
+            size_t readA = std::fread(bufferA, sizeof(uint32_t), 1024, a);
+            size_t readB = std::fread(bufferB, sizeof(uint32_t), 1024, b);
+            size_t common = std::min(readA, readB);
+            for (size_t i = 0; i < common; ++i) {
+                if (bufferA[i] != bufferB[i]) {
+                    divergence = tick + static_cast<int64_t>(i);
+                    break;
+                }
+            }
+            if (divergence >= 0) break;
+            if (readA != readB) {
+                // One run stopped early (e.g. died): the shorter one has no
+                // tick at the point the other continues.
+                divergence = tick + static_cast<int64_t>(common);
+                break;
+            }
+            if (std::ferror(a) || std::ferror(b)) {
+                divergence = kChecksumReadError;
+                break;
+            }
+            if (common < 1024) break;
+            tick += 1024;
+        }
+    }
+
+    if (a) std::fclose(a);
+    if (b) std::fclose(b);
+    return divergence;
+}
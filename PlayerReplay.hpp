@@ -0,0 +1,122 @@
+#pragma once
+
+#include "main.hpp"
+#include <cstdio>
+
+struct HeadlessInputEvent;
+struct PlayerPhysicsState;
+
+// ==============================================
+// INPUT REPLAYS & PER-TICK CHECKSUMS
+// ==============================================
+//
+// Replay file (.gdr):
+//   "GDRP" | u16 version | records...
+//   record = varint(tick delta since previous record) | u8 flags
+//   flags  = bit 7: player 2, bit 6: pressed, bits 0-5: PlayerButton
+// A press and a release a few ticks apart cost 2 bytes each.
+//
+// Checksum file (.gdc):
+//   "GDCS" | u16 version | u32 low bits of hashPlayerState() per tick
+//
+// Writers buffer 4 KB in memory and only touch the file when the buffer
+// fills, so recording costs a couple of stores per event/tick.
+
+struct ReplayEvent {
+    uint32_t tick;
+    uint8_t  player;   // 0 = player 1, 1 = player 2
+    uint8_t  button;   // PlayerButton value
+    bool     pressed;
+};
+
+class BufferedFileWriter {
+public:
+    BufferedFileWriter() = default;
+    ~BufferedFileWriter() { close(); }
+
+    BufferedFileWriter(const BufferedFileWriter&) = delete;
+    BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return m_file != nullptr; }
+
+    void write(const void* data, size_t size);
+    void writeByte(uint8_t value) {
+        if (m_used == sizeof(m_buffer)) flush();
+        m_buffer[m_used++] = value;
+    }
+    void flush();
+
+private:
+    FILE*   m_file = nullptr;
+    size_t  m_used = 0;
+    uint8_t m_buffer[4096];
+};
+
+class ReplayRecorder {
+public:
+    static constexpr uint16_t kVersion = 1;
+
+    bool open(const std::string& path);
+    void close() { m_writer.close(); }
+    bool isRecording() const { return m_writer.isOpen(); }
+
+    // Level restart: the stepper's tick goes back to 0, so the file starts
+    // over with the new attempt (deltas can't go backwards).
+    void restart();
+
+    // Called from PlayerObject::pushButton / releaseButton.
+    void record(uint32_t tick, uint8_t player, uint8_t button, bool pressed);
+
+private:
+    BufferedFileWriter m_writer;
+    std::string m_path;
+    uint32_t m_lastTick = 0;
+};
+
+class ReplayPlayer {
+public:
+    bool load(const std::string& path);
+    void rewind() { m_cursor = 0; }
+
+    // Returns the events due at or before tick that have not been handed out
+    // yet, as [begin, end) into events(). Call once per simulated tick.
+    std::pair<size_t, size_t> eventsUntil(uint32_t tick);
+
+    const std::vector<ReplayEvent>& events() const { return m_events; }
+
+    // Jump-button presses/releases in the headless runner's input format.
+    std::vector<HeadlessInputEvent> toHeadlessInputs() const;
+
+private:
+    std::vector<ReplayEvent> m_events;
+    size_t m_cursor = 0;
+};
+
+class ReplayChecksumWriter {
+public:
+    static constexpr uint16_t kVersion = 1;
+
+    bool open(const std::string& path);
+    void close() { m_writer.close(); }
+
+    void writeTick(const PlayerPhysicsState& state);
+
+    // PlayerPhysicsStepper::TickObserver adapter (context = this writer).
+    static void onStepperTick(void* context, const PlayerPhysicsState& state, uint32_t tick);
+
+private:
+    BufferedFileWriter m_writer;
+};
+
+// Both writers checksum the stepper state right after each substep's
+// integrate (PlayerObject via setChecksumWriter, HeadlessLevelSimulator::run
+// through the same tick observer), so the two streams line up tick for tick.
+
+constexpr int64_t kChecksumsMatch = -1;
+constexpr int64_t kChecksumReadError = -2;   // missing file, bad header or read error
+
+// First tick at which two checksum files differ. If one file is a strict
+// prefix of the other, that is the length of the shorter one.
+int64_t findFirstDivergence(const std::string& checksumPathA, const std::string& checksumPathB);
@@ -0,0 +1,60 @@
+// PlayerUpdateWorker.cpp
+#include "PlayerUpdateWorker.hpp"
+
+bool PlayerUpdateWorker::isSupported() {
+    return std::thread::hardware_concurrency() > 1;
+}
+
+void PlayerUpdateWorker::start() {
+    m_quit = false;
+    m_thread = std::thread(&PlayerUpdateWorker::threadMain, this);
+}
+
+void PlayerUpdateWorker::stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void PlayerUpdateWorker::dispatch(Task task, void* context) {
+    if (!m_thread.joinable()) {
+        start();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = task;
+        m_context = context;
+        m_busy = true;
+    }
+    m_wake.notify_one();
+}
+
+void PlayerUpdateWorker::wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return !m_busy; });
+}
+
+void PlayerUpdateWorker::threadMain() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this] { return m_busy || m_quit; });
+        if (m_quit) {
+            return;
+        }
+
+        Task task = m_task;
+        void* context = m_context;
+        lock.unlock();
+        task(context);
+        lock.lock();
+
+        m_busy = false;
+        m_done.notify_one();
+    }
+}
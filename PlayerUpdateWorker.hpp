@@ -0,0 +1,55 @@
+#pragma once
+
+#include "main.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// ==============================================
+// DUAL MODE PLAYER WORKER
+// ==============================================
+//
+// One long-lived background thread that GJBaseGameLayer hands player 2's
+// per-frame physics and collision work to, while the main thread steps
+// player 1. dispatch() wakes the worker, wait() is the join point; nothing
+// that touches state shared by both players may run between the two.
+//
+// The thread is started on first use and joined by stop() / the destructor,
+// so single-player levels never create it.
+
+class PlayerUpdateWorker {
+public:
+    using Task = void (*)(void* context);
+
+    PlayerUpdateWorker() = default;
+    ~PlayerUpdateWorker() { stop(); }
+
+    PlayerUpdateWorker(const PlayerUpdateWorker&) = delete;
+    PlayerUpdateWorker& operator=(const PlayerUpdateWorker&) = delete;
+
+    // False on single-core devices; callers fall back to the serial path.
+    static bool isSupported();
+
+    // Runs task(context) on the worker. At most one task is in flight.
+    void dispatch(Task task, void* context);
+
+    // Blocks until the dispatched task has finished.
+    void wait();
+
+    void stop();
+
+private:
+    void start();
+    void threadMain();
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    Task  m_task = nullptr;
+    void* m_context = nullptr;
+    bool  m_busy = false;
+    bool  m_quit = false;
+};
@@ -2,8 +2,20 @@
 #include "SimplePlayer.hpp"
 #include "SimplePlayer.h"
 #include "GameManager.h"
+#include "PlayerIconCache.hpp"
 #include "cocos2d.h"
 
+// ==============================================
+// SIMPLEPLAYER CONSTRUCTOR
+// ==============================================
+
+SimplePlayer::SimplePlayer() {
+    // No PlayerIconCache reference until updatePlayerFrame takes one (0 would
+    // read as a Cube reference the destructor never acquired)
+    this->m_iconType = -1;
+    this->m_hasRequestIcons = false;
+}
+
 // ==============================================
 // SIMPLEPLAYER DESTRUCTOR - FULL IMPLEMENTATION
 // ==============================================
@@ -14,14 +26,26 @@ SimplePlayer::~SimplePlayer() {
     this->colorable_vtable = &Colorable_vtable;         // +0x140 offset
     this->blendable_vtable = &Blendable_vtable;         // +0x158 offset
     
-    // ===== STEP 1: UNLOAD PLAYER ICONS =====
+    // ===== STEP 1: RELEASE PLAYER ICONS =====
     
-    // Get GameManager singleton
-    GameManager* gameManager = GameManager::sharedState();
+    // Icon sheets taken through updatePlayerFrame are shared through
+    // PlayerIconCache; the last SimplePlayer to drop one parks it for lazy
+    // unloading instead of unloading it here
+    if (this->m_iconType >= 0) {
+        PlayerIconCache::sharedCache()->release(
+            {this->m_iconID, static_cast<PlayerIconType>(this->m_iconType)});
+        this->m_iconType = -1;
+    }
     
-    // Unload icons for this player
+    // Icons loaded under this player's own request ID (loadRequestIcon) are
+    // still unloaded per instance; players that only used the cache have
+    // nothing under it
+    GameManager* gameManager = GameManager::sharedState();
     int playerIconID = this->m_playerIconID;            // +0x298
-    gameManager->unloadIcons(playerIconID);
+    if (this->m_hasRequestIcons) {
+        gameManager->unloadIcons(playerIconID);
+        this->m_hasRequestIcons = false;
+    }
     
     // ===== STEP 2: REMOVE ICON DELEGATE =====
     
@@ -36,3 +60,31 @@ SimplePlayer::~SimplePlayer() {
     // SimplePlayer inherits from CCSprite
     cocos2d::CCSprite::~CCSprite();
 }
+
+// ==============================================
+// SIMPLEPLAYER ICON SELECTION
+// ==============================================
+
+// Swaps the displayed icon, moving this player's PlayerIconCache reference
+// from the old sheet to the new one. Taking the new reference first keeps a
+// sheet shared by both alive across the switch.
+void SimplePlayer::updatePlayerFrame(int iconID, PlayerIconType type) {
+    PlayerIconCache* icons = PlayerIconCache::sharedCache();
+    icons->acquire({iconID, type});
+    if (this->m_iconType >= 0) {
+        icons->release({this->m_iconID, static_cast<PlayerIconType>(this->m_iconType)});
+    }
+    this->m_iconID = iconID;
+    this->m_iconType = static_cast<int>(type);
+
+    // Sprite frames are registered by the cache's load; just pick them up
+    this->setFrames(iconID, type);
+}
+
+// Loads a sheet under this player's own request ID, outside the cache, for
+// callers that track the load themselves through the icon delegate. The
+// destructor unloads everything under the ID.
+void SimplePlayer::loadRequestIcon(int iconID, PlayerIconType type) {
+    GameManager::sharedState()->loadIcon(iconID, static_cast<int>(type), this->m_playerIconID);
+    this->m_hasRequestIcons = true;
+}
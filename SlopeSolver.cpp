@@ -0,0 +1,129 @@
+// SlopeSolver.cpp
+#include "SlopeSolver.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+SlopeGeometry SlopeSolver::makeGeometry(float x, float y, float width, float height,
+                                        bool flipX, bool flipY) {
+    SlopeGeometry geometry;
+    geometry.minX = x;
+    geometry.maxX = x + width;
+    geometry.minY = y;
+    geometry.maxY = y + height;
+    geometry.surfaceOnTop = !flipY;
+
+    // Unflipped slopes rise to the right. Flipping on X mirrors the ramp,
+    // flipping on Y hangs it from the ceiling, which mirrors it vertically.
+    bool rising = (flipX == flipY);
+    float run = width > 0.0f ? width : 1.0f;
+    geometry.gradient = (rising ? height : -height) / run;
+    geometry.intercept = (rising ? geometry.minY : geometry.maxY) - geometry.gradient * geometry.minX;
+    return geometry;
+}
+
+void SlopeSolver::addSlope(uint32_t collisionIndex, float x, float y, float width, float height,
+                           bool flipX, bool flipY) {
+    if (collisionIndex >= m_slopeForObject.size()) {
+        m_slopeForObject.resize(collisionIndex + 1, -1);
+    }
+    m_slopeForObject[collisionIndex] = static_cast<int32_t>(m_slopes.size());
+    m_slopes.push_back(makeGeometry(x, y, width, height, flipX, flipY));
+}
+
+void SlopeSolver::link() {
+    // Sort slope indices by left edge once; each slope's successor can only
+    // start where it ends, so a binary search finds the candidates.
+    std::vector<int32_t> order(m_slopes.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int32_t>(i);
+    std::sort(order.begin(), order.end(), [this](int32_t a, int32_t b) {
+        return m_slopes[a].minX < m_slopes[b].minX;
+    });
+
+    for (SlopeGeometry& slope : m_slopes) {
+        slope.prev = slope.next = -1;
+    }
+
+    for (int32_t index : order) {
+        SlopeGeometry& current = m_slopes[index];
+        float endX = current.maxX;
+        float endY = current.heightAt(endX);
+
+        auto first = std::lower_bound(order.begin(), order.end(), endX - kChainTolerance,
+                                      [this](int32_t slopeIndex, float x) { return m_slopes[slopeIndex].minX < x; });
+        for (auto it = first; it != order.end() && m_slopes[*it].minX <= endX + kChainTolerance; ++it) {
+            SlopeGeometry& candidate = m_slopes[*it];
+            if (*it == index || candidate.prev != -1 || candidate.surfaceOnTop != current.surfaceOnTop) {
+                continue;
+            }
+            if (std::fabs(candidate.heightAt(candidate.minX) - endY) <= kChainTolerance) {
+                current.next = *it;
+                candidate.prev = index;
+                break;
+            }
+        }
+    }
+}
+
+void SlopeSolver::clear() {
+    m_slopes.clear();
+    m_slopeForObject.clear();
+}
+
+void SlopeSolver::updateSlope(uint32_t collisionIndex, float x, float y, float width, float height,
+                              bool flipX, bool flipY) {
+    int32_t index = slopeIndexFor(collisionIndex);
+    if (index < 0) return;
+
+    SlopeGeometry& slope = m_slopes[index];
+    if (slope.prev >= 0) m_slopes[slope.prev].next = -1;
+    if (slope.next >= 0) m_slopes[slope.next].prev = -1;
+
+    slope = makeGeometry(x, y, width, height, flipX, flipY);
+}
+
+float SlopeSolver::contactHeight(int32_t& slopeIndex, float playerMinX, float playerMaxX) const {
+    const SlopeGeometry* slope = &m_slopes[slopeIndex];
+
+    // Follow the chain while the player has fully left the current piece.
+    while (playerMinX > slope->maxX && slope->next >= 0) {
+        slopeIndex = slope->next;
+        slope = &m_slopes[slopeIndex];
+    }
+    while (playerMaxX < slope->minX && slope->prev >= 0) {
+        slopeIndex = slope->prev;
+        slope = &m_slopes[slopeIndex];
+    }
+
+    // The highest point of a floor under the box is at the edge facing uphill
+    // (the lowest point for ceilings).
+    bool useRightEdge = (slope->gradient >= 0.0f) == slope->surfaceOnTop;
+    float x = useRightEdge ? playerMaxX : playerMinX;
+    float height = slope->heightAt(std::min(std::max(x, slope->minX), slope->maxX));
+
+    // That edge may already be over the neighbouring piece of the chain.
+    int32_t neighbour = x > slope->maxX ? slope->next : (x < slope->minX ? slope->prev : -1);
+    if (neighbour >= 0) {
+        const SlopeGeometry& other = m_slopes[neighbour];
+        float otherHeight = other.heightAt(std::min(std::max(x, other.minX), other.maxX));
+        height = slope->surfaceOnTop ? std::max(height, otherHeight) : std::min(height, otherHeight);
+    }
+    return height;
+}
+
+bool SlopeSolver::contactHeightFor(uint32_t collisionIndex, int32_t& currentSlope, float playerMinX,
+                                   float playerMaxX, float& height) const {
+    int32_t slopeIndex = slopeIndexFor(collisionIndex);
+    if (slopeIndex < 0) {
+        return false;
+    }
+    if (currentSlope >= 0 && currentSlope < static_cast<int32_t>(m_slopes.size())) {
+        const SlopeGeometry& current = m_slopes[currentSlope];
+        if (slopeIndex == current.next || slopeIndex == current.prev) {
+            slopeIndex = currentSlope;
+        }
+    }
+    height = contactHeight(slopeIndex, playerMinX, playerMaxX);
+    currentSlope = slopeIndex;
+    return true;
+}
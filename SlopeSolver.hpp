@@ -0,0 +1,73 @@
+#pragma once
+
+#include "main.hpp"
+
+// ==============================================
+// PRECOMPUTED SLOPE GEOMETRY
+// ==============================================
+//
+// PlayerObject::slopeYPos used to return the slope object's getPositionY().
+// The solver stores each slope's surface as a line y = m * x + b plus its
+// bounds, computed once when the level loads (or when a trigger moves the
+// slope), so a per-tick contact height is one multiply-add and a clamp.
+//
+// Consecutive slopes whose ends meet are linked into chains at build time;
+// when the player runs off one end of a slope the solver follows the link
+// instead of re-scanning the player's slope contacts.
+
+struct SlopeGeometry {
+    float minX, maxX;
+    float minY, maxY;
+    float gradient;       // m
+    float intercept;      // b
+    bool  surfaceOnTop;   // false for ceiling slopes (object flipped on Y)
+    int32_t prev = -1;    // slope continuing to the left, -1 if none
+    int32_t next = -1;    // slope continuing to the right, -1 if none
+
+    float heightAt(float x) const { return gradient * x + intercept; }
+};
+
+class SlopeSolver {
+public:
+    // Max gap between chained slope ends, in level units.
+    static constexpr float kChainTolerance = 0.5f;
+
+    // Level load: one call per slope object, then link().
+    // collisionIndex is the object's broad-phase slot.
+    void addSlope(uint32_t collisionIndex, float x, float y, float width, float height,
+                  bool flipX, bool flipY);
+    void link();
+    void clear();
+
+    // A trigger moved or rescaled the slope; its chain links are dropped
+    // because neighbours are no longer guaranteed to line up.
+    void updateSlope(uint32_t collisionIndex, float x, float y, float width, float height,
+                     bool flipX, bool flipY);
+
+    int32_t slopeIndexFor(uint32_t collisionIndex) const {
+        return collisionIndex < m_slopeForObject.size() ? m_slopeForObject[collisionIndex] : -1;
+    }
+
+    const SlopeGeometry& slope(int32_t slopeIndex) const { return m_slopes[slopeIndex]; }
+
+    // Height of the slope surface under a player whose box spans
+    // [playerMinX, playerMaxX]. Rising floors are met by the player's right
+    // edge, falling floors by its left edge. If that edge has run past the
+    // slope, the chain is followed and slopeIndex is updated to the slope
+    // that now supports the player.
+    float contactHeight(int32_t& slopeIndex, float playerMinX, float playerMaxX) const;
+
+    // Contact with slope object collisionIndex by a player that last rode
+    // currentSlope (-1 if none). Touching a neighbour of currentSlope keeps
+    // riding it, so consecutive slopes hand over without looking at the
+    // other contacts. Updates currentSlope; false if the object isn't a
+    // slope. PlayerObject::slopeYPos and HeadlessLevelSimulator share this.
+    bool contactHeightFor(uint32_t collisionIndex, int32_t& currentSlope, float playerMinX, float playerMaxX,
+                          float& height) const;
+
+private:
+    static SlopeGeometry makeGeometry(float x, float y, float width, float height, bool flipX, bool flipY);
+
+    std::vector<SlopeGeometry> m_slopes;
+    std::vector<int32_t> m_slopeForObject;   // collision index -> slope index
+};
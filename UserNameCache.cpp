@@ -0,0 +1,147 @@
+// UserNameCache.cpp
+#include "UserNameCache.hpp"
+
+#include <algorithm>
+
+UserNameCache::UserNameCache(size_t capacity) : m_capacity(std::max<size_t>(capacity, 1)) {}
+
+// ============================================================================
+// LRU list
+// ============================================================================
+
+void UserNameCache::unlink(uint32_t slot) {
+    Slot& entry = m_slots[slot];
+    if (entry.prev != kNone) m_slots[entry.prev].next = entry.next;
+    else m_head = entry.next;
+    if (entry.next != kNone) m_slots[entry.next].prev = entry.prev;
+    else m_tail = entry.prev;
+    entry.prev = entry.next = kNone;
+}
+
+void UserNameCache::pushFront(uint32_t slot) {
+    Slot& entry = m_slots[slot];
+    entry.prev = kNone;
+    entry.next = m_head;
+    if (m_head != kNone) m_slots[m_head].prev = slot;
+    m_head = slot;
+    if (m_tail == kNone) m_tail = slot;
+}
+
+void UserNameCache::touch(uint32_t slot) {
+    if (slot != m_head) {
+        unlink(slot);
+        pushFront(slot);
+    }
+}
+
+void UserNameCache::evictOldest() {
+    uint32_t slot = m_tail;
+    if (slot == kNone) {
+        return;
+    }
+    unlink(slot);
+
+    Record& record = m_slots[slot].record;
+    if (record.accountID > 0) {
+        auto account = m_userByAccount.find(record.accountID);
+        if (account != m_userByAccount.end() && account->second == record.userID) {
+            m_userByAccount.erase(account);
+        }
+    }
+    m_byUser.erase(record.userID);
+    record.name.clear();  // keeps its capacity for the next user
+    m_freeSlots.push_back(slot);
+    ++m_evictions;
+}
+
+// ============================================================================
+// Store / lookup
+// ============================================================================
+
+void UserNameCache::store(int userID, int accountID, std::string_view name) {
+    if (userID <= 0) {
+        return;
+    }
+
+    uint32_t slot;
+    auto existing = m_byUser.find(userID);
+    if (existing != m_byUser.end()) {
+        slot = existing->second;
+        touch(slot);
+    } else {
+        if (m_byUser.size() >= m_capacity) {
+            evictOldest();
+        }
+        if (!m_freeSlots.empty()) {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(m_slots.size());
+            m_slots.emplace_back();
+        }
+        m_slots[slot].record.userID = userID;
+        m_slots[slot].record.accountID = 0;
+        m_byUser.emplace(userID, slot);
+        pushFront(slot);
+    }
+
+    Record& record = m_slots[slot].record;
+    record.name.assign(name.data(), name.size());
+    if (accountID > 0) {
+        if (record.accountID > 0 && record.accountID != accountID) {
+            // The old account may already belong to another user
+            auto account = m_userByAccount.find(record.accountID);
+            if (account != m_userByAccount.end() && account->second == userID) {
+                m_userByAccount.erase(account);
+            }
+        }
+        record.accountID = accountID;
+        m_userByAccount[accountID] = userID;
+    }
+}
+
+const UserNameCache::Record* UserNameCache::findUser(int userID) {
+    auto found = m_byUser.find(userID);
+    if (found == m_byUser.end()) {
+        ++m_misses;
+        return nullptr;
+    }
+    ++m_hits;
+    touch(found->second);
+    return &m_slots[found->second].record;
+}
+
+const UserNameCache::Record* UserNameCache::findAccount(int accountID) {
+    auto account = m_userByAccount.find(accountID);
+    if (account == m_userByAccount.end()) {
+        ++m_misses;
+        return nullptr;
+    }
+    return findUser(account->second);
+}
+
+// ============================================================================
+// Sizing
+// ============================================================================
+
+void UserNameCache::reserve(size_t count) {
+    count = std::min(count, m_capacity);
+    m_slots.reserve(count);
+    m_byUser.reserve(count);
+    m_userByAccount.reserve(count);
+}
+
+void UserNameCache::setCapacity(size_t capacity) {
+    m_capacity = std::max<size_t>(capacity, 1);
+    while (m_byUser.size() > m_capacity) {
+        evictOldest();
+    }
+}
+
+void UserNameCache::clear() {
+    m_slots.clear();
+    m_freeSlots.clear();
+    m_byUser.clear();
+    m_userByAccount.clear();
+    m_head = m_tail = kNone;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "main.hpp"
+
+#include <string_view>
+
+// ==============================================
+// BOUNDED USER NAME CACHE
+// ==============================================
+//
+// Replaces GameLevelManager's m_userNameDict (userID string -> name),
+// m_userIdDict (userID -> "%i" accountID) and m_accountIdDict (accountID ->
+// "%i" userID), which were keyed by formatted strings and never shrank.
+//
+// One record per userID holds the name and account ID; a second hash map
+// resolves accountID -> userID. Records live in a slab linked in LRU order;
+// when the cache is full, storing a new user evicts the least recently
+// stored or looked-up one. Lookups never allocate.
+
+class UserNameCache {
+public:
+    static constexpr size_t kDefaultCapacity = 20000;
+
+    struct Record {
+        int userID = 0;
+        int accountID = 0;
+        std::string name;
+    };
+
+    explicit UserNameCache(size_t capacity = kDefaultCapacity);
+
+    // Inserts or refreshes userID. accountID <= 0 keeps the known one.
+    void store(int userID, int accountID, std::string_view name);
+
+    // nullptr on miss; the record stays valid until the next store/clear.
+    const Record* findUser(int userID);
+    const Record* findAccount(int accountID);
+
+    // Pre-sizes for a bulk store of count users (capped at the capacity).
+    void reserve(size_t count);
+
+    // Shrinking evicts least recently used users immediately.
+    void setCapacity(size_t capacity);
+    size_t capacity() const { return m_capacity; }
+    size_t size() const { return m_byUser.size(); }
+
+    void clear();
+
+    uint64_t hits() const { return m_hits; }
+    uint64_t misses() const { return m_misses; }
+    uint64_t evictions() const { return m_evictions; }
+    void resetCounters() { m_hits = m_misses = m_evictions = 0; }
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct Slot {
+        Record record;
+        uint32_t prev = kNone;  // towards most recently used
+        uint32_t next = kNone;  // towards least recently used
+    };
+
+    void unlink(uint32_t slot);
+    void pushFront(uint32_t slot);
+    void touch(uint32_t slot);
+    void evictOldest();
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    std::unordered_map<int, uint32_t> m_byUser;
+    std::unordered_map<int, int> m_userByAccount;
+    uint32_t m_head = kNone;  // most recently used
+    uint32_t m_tail = kNone;  // least recently used
+    size_t m_capacity;
+
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_evictions = 0;
+};
@@ -0,0 +1,278 @@
+// bench/EditorAutoSaveBench.cpp
+//
+// Worst editor-thread stall of an autosave on a 200k-object level, against
+// serializing and compressing the whole level on the editor thread, which
+// autosave did before. Passes are sliced the way LevelEditorLayer slices
+// them (kSliceObjects per 16 ms frame) and handed to a writer thread that
+// runs EditorAutoSave. Passes: the whole level, a 500-object drag, 20
+// scattered edits and a 3000-object delete. The autosave is then read back
+// and parsed as restoreAutoSave's deserializeLevel does: the level header
+// and every object must match the level.
+//
+// From the repository root, with the game headers on the include path:
+//   g++ -std=c++17 -O2 -I. bench/EditorAutoSaveBench.cpp EditorAutoSave.cpp EditorObjectRecord.cpp MappedFile.cpp -lz -lpthread
+//   ./a.out [autosave path]
+
+#include "../EditorAutoSave.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+#include <zlib.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+constexpr int kObjects = 200000;
+constexpr size_t kSliceObjects = 8192;   // LevelEditorLayer's kAutoSaveSliceObjects
+const char* kLevelHeader = "kS38,1_40_2_125_3_255_11_255_12_255_13_255_4_-1_6_1000_7_1_15_1_18_0_8_1|,kA13,0,kA15,0";
+
+// Stand-in for the GameObject state editorRecordOf reads.
+struct Object {
+    EditorObjectRecord record;
+    bool removed = false;
+};
+
+class Writer {
+public:
+    explicit Writer(std::string path) : m_path(std::move(path)), m_thread(&Writer::main, this) {}
+
+    ~Writer() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_quit = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+
+    void push(AutoSaveBatch batch) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push_back(std::move(batch));
+        }
+        m_wake.notify_one();
+    }
+
+    // Blocks until a write newer than `after` has finished.
+    double waitForWrite(int after) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_written.wait(lock, [&] { return m_queue.empty() && m_writes > after; });
+        return m_writeMs;
+    }
+
+    int writes() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_writes;
+    }
+
+    size_t objectCount() const { return m_save.objectCount(); }
+
+private:
+    void main() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            m_wake.wait(lock, [this] { return !m_queue.empty() || m_quit; });
+            if (m_queue.empty()) {
+                return;
+            }
+            std::vector<AutoSaveBatch> batches;
+            batches.swap(m_queue);
+            lock.unlock();
+
+            size_t lastComplete = batches.size();
+            for (size_t i = 0; i < batches.size(); ++i) {
+                if (batches[i].complete) lastComplete = i;
+            }
+            double writeMs = -1.0;
+            for (size_t i = 0; i < batches.size(); ++i) {
+                m_save.apply(batches[i]);
+                if (i == lastComplete) {
+                    auto start = Clock::now();
+                    m_save.write(m_path);
+                    writeMs = elapsedMs(start);
+                }
+            }
+
+            lock.lock();
+            if (writeMs >= 0.0) {
+                m_writeMs = writeMs;
+                ++m_writes;
+                m_written.notify_all();
+            }
+        }
+    }
+
+    std::string m_path;
+    EditorAutoSave m_save;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_written;
+    std::vector<AutoSaveBatch> m_queue;
+    double m_writeMs = 0.0;
+    int m_writes = 0;
+    bool m_quit = false;
+    std::thread m_thread;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string path = argc > 1 ? argv[1] : "/tmp/EditorAutoSaveBench.dat";
+
+    std::mt19937 rng(3);
+    std::vector<Object> objects(kObjects);
+    std::unordered_map<int, Object*> byID;
+    for (int i = 0; i < kObjects; ++i) {
+        EditorObjectRecord& record = objects[i].record;
+        record.uniqueID = i + 1;
+        record.objectID = static_cast<int32_t>(1 + rng() % 1800);
+        record.x = static_cast<float>(rng() % 60000) * 0.5f;
+        record.y = static_cast<float>(rng() % 4000) * 0.5f;
+        record.rotation = static_cast<float>((rng() % 8) * 45);
+        record.zOrder = static_cast<int32_t>(rng() % 3);
+        record.mainColor = static_cast<int16_t>(rng() % 5);
+        record.detailColor = static_cast<int16_t>(rng() % 3);
+        record.groupCount = static_cast<uint8_t>(rng() % 3);
+        for (int g = 0; g < record.groupCount; ++g) {
+            record.groups[g] = static_cast<int16_t>(1 + rng() % 900);
+        }
+        byID[record.uniqueID] = &objects[i];
+    }
+
+    // What autosave did before: the whole level, on the editor thread.
+    {
+        auto start = Clock::now();
+        std::string text;
+        for (const Object& object : objects) {
+            if (!text.empty()) text.push_back(';');
+            appendObjectString(object.record, text);
+        }
+        double serializeMs = elapsedMs(start);
+        std::vector<uint8_t> compressed(compressBound(static_cast<uLong>(text.size())));
+        uLongf compressedSize = static_cast<uLongf>(compressed.size());
+        compress2(compressed.data(), &compressedSize, reinterpret_cast<const Bytef*>(text.data()),
+                  static_cast<uLong>(text.size()), Z_DEFAULT_COMPRESSION);
+        std::printf("full save on the editor thread: %.1f ms (serialize %.1f ms, %zu -> %lu bytes)\n",
+                    elapsedMs(start), serializeMs, text.size(), static_cast<unsigned long>(compressedSize));
+    }
+
+    AutoSaveChanges changes;
+    Writer writer(path);
+
+    auto pass = [&](const char* label) {
+        std::vector<int> ids;
+        bool reset = false;
+        int writes = writer.writes();
+        double worstMs = 0.0;
+        int frames = 0;
+
+        auto start = Clock::now();
+        changes.take(ids, reset);
+        size_t cursor = 0;
+        for (;;) {
+            AutoSaveBatch batch;
+            batch.reset = reset;
+            reset = false;
+            size_t end = std::min(ids.size(), cursor + kSliceObjects);
+            batch.changed.reserve(end - cursor);
+            for (; cursor < end; ++cursor) {
+                int id = ids[cursor];
+                switch (changes.consume(id)) {
+                case AutoSaveChanges::kChanged: {
+                    auto it = byID.find(id);
+                    if (it != byID.end()) {
+                        batch.changed.push_back(it->second->record);
+                        break;
+                    }
+                    batch.removed.push_back(id);
+                    break;
+                }
+                case AutoSaveChanges::kRemoved:
+                    batch.removed.push_back(id);
+                    break;
+                default:
+                    break;
+                }
+            }
+            batch.complete = cursor == ids.size();
+            if (batch.complete) {
+                batch.levelHeader = kLevelHeader;
+            }
+            writer.push(std::move(batch));
+            worstMs = std::max(worstMs, elapsedMs(start));
+            ++frames;
+            if (cursor == ids.size()) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+            start = Clock::now();
+        }
+        double writeMs = writer.waitForWrite(writes);
+        std::printf("%-26s %6zu objects over %2d frames: worst editor-thread slice %.3f ms | "
+                    "autosave thread write %.1f ms\n",
+                    label, ids.size(), frames, worstMs, writeMs);
+    };
+
+    changes.markReset();
+    for (const Object& object : objects) {
+        changes.markChanged(object.record.uniqueID);
+    }
+    pass("first pass (whole level)");
+
+    for (int i = 0; i < 500; ++i) {
+        EditorObjectRecord& record = objects[20000 + i].record;
+        record.x += 30.0f;
+        changes.markChanged(record.uniqueID);
+    }
+    pass("drag 500 objects");
+
+    for (int i = 0; i < 20; ++i) {
+        EditorObjectRecord& record = objects[rng() % kObjects].record;
+        record.rotation += 90.0f;
+        changes.markChanged(record.uniqueID);
+    }
+    pass("20 scattered edits");
+
+    for (int i = 0; i < 3000; ++i) {
+        Object& object = objects[100000 + i];
+        object.removed = true;
+        changes.markRemoved(object.record.uniqueID);
+        byID.erase(object.record.uniqueID);
+    }
+    pass("delete 3000");
+
+    std::string restored;
+    bool ok = EditorAutoSave::read(path, restored);
+    std::string expected;
+    for (const Object& object : objects) {
+        if (object.removed) continue;
+        if (!expected.empty()) expected.push_back(';');
+        appendObjectString(object.record, expected);
+    }
+    std::vector<EditorObjectRecord> records;
+    std::string levelHeader;
+    std::string restoredObjects;
+    if (ok && parseObjectStrings(restored, records, &levelHeader)) {
+        appendObjectStrings(records, restoredObjects);
+    }
+    if (!ok || levelHeader != kLevelHeader || restoredObjects != expected) {
+        std::printf("MISMATCH: the autosave doesn't read back as the level (%zu objects saved, header %s)\n",
+                    writer.objectCount(), levelHeader == kLevelHeader ? "kept" : "lost");
+        return 1;
+    }
+    std::printf("restored %zu objects and the level header, same as the level\n", records.size());
+    std::remove(path.c_str());
+    return 0;
+}
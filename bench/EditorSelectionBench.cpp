@@ -0,0 +1,238 @@
+// bench/EditorSelectionBench.cpp
+//
+// Lasso and magic-wand selection on a 500k-object level, against the 16 ms
+// frame budget the editor has for them. Objects are 10-30 unit squares of
+// eight object types spread as in EditorSpatialIndexBench, plus the dense
+// region: a 15000x1200 wall of blocks on the 30-unit grid with two
+// decorations per block, 60k objects. Queries:
+//   lasso   a freehand loop of 600 touch points around the wall and some
+//           of the level beside it (thinned at 2 units, as
+//           selectWithLasso does)
+//   wand    the wall's blocks from a seed among them, gap 5, same type
+// The median and worst of the runs are reported; a median over the budget
+// is flagged.
+//
+// Selections are checked against brute force on a 20k-object level: every
+// object's center tested against every lasso edge, and a flood that scans
+// all objects for the neighbours of each one it selects.
+//
+// From the repository root, with the game headers on the include path:
+//   g++ -std=c++17 -O2 -I. bench/EditorSelectionBench.cpp EditorSelectionQueries.cpp EditorSpatialIndex.cpp CollisionBroadPhase.cpp
+//   ./a.out
+
+#include "../EditorSelectionQueries.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+constexpr double kFrameBudgetMs = 16.0;
+constexpr int kRuns = 20;
+constexpr float kLassoMinSpacing = 2.0f;
+constexpr float kWandGap = 5.0f;
+constexpr int kWallRows = 40;
+constexpr int kLassoPoints = 600;
+
+struct Level {
+    std::vector<BroadPhaseRect> bounds;
+    std::vector<uint8_t> types;
+    BroadPhaseRect wall;
+};
+
+// count objects in all. A fifth of them (at most 60k) build the wall: type 0
+// blocks filling kWallRows rows of 30-unit grid cells edge to edge, each
+// cell with two decorations of other types on top. The rest are 10-30 unit
+// objects of any type scattered over the level.
+Level makeLevel(size_t count, std::mt19937& rng) {
+    Level level;
+    int wallCells = static_cast<int>(std::min(count / 5, size_t(60000)) / 3);
+    int wallColumns = wallCells / kWallRows;
+    float width = 30.0f * static_cast<float>(count / 100);
+    float wallX = std::floor(width * 0.5f / 30.0f) * 30.0f;
+    level.wall = {wallX, 900.0f, wallX + 30.0f * static_cast<float>(wallColumns), 900.0f + 30.0f * kWallRows};
+
+    std::uniform_real_distribution<float> randomX(0.0f, width);
+    std::uniform_real_distribution<float> randomY(0.0f, 3000.0f);
+    std::uniform_real_distribution<float> randomSize(10.0f, 30.0f);
+    std::uniform_real_distribution<float> randomOffset(0.0f, 20.0f);
+    for (int column = 0; column < wallColumns; ++column) {
+        for (int row = 0; row < kWallRows; ++row) {
+            float x = level.wall.minX + 30.0f * static_cast<float>(column);
+            float y = level.wall.minY + 30.0f * static_cast<float>(row);
+            level.bounds.push_back({x, y, x + 30.0f, y + 30.0f});
+            level.types.push_back(0);
+            for (int decoration = 0; decoration < 2; ++decoration) {
+                float dx = x + randomOffset(rng);
+                float dy = y + randomOffset(rng);
+                level.bounds.push_back({dx, dy, dx + 10.0f, dy + 10.0f});
+                level.types.push_back(static_cast<uint8_t>(1 + rng() % 7));
+            }
+        }
+    }
+    while (level.bounds.size() < count) {
+        float x = randomX(rng);
+        float y = randomY(rng);
+        float size = randomSize(rng);
+        level.bounds.push_back({x, y, x + size, y + size});
+        level.types.push_back(static_cast<uint8_t>(rng() % 8));
+    }
+    return level;
+}
+
+// A wobbly loop of kLassoPoints touch points, margin units outside area.
+std::vector<SelectionPoint> makeLasso(const BroadPhaseRect& area, float margin, std::mt19937& rng) {
+    std::uniform_real_distribution<float> wobble(-0.5f, 0.5f);
+    float cx = (area.minX + area.maxX) * 0.5f;
+    float cy = (area.minY + area.maxY) * 0.5f;
+    float rx = (area.maxX - area.minX) * 0.5f * 1.42f + margin;
+    float ry = (area.maxY - area.minY) * 0.5f * 1.42f + margin;
+    std::vector<SelectionPoint> points;
+    for (int i = 0; i < kLassoPoints; ++i) {
+        float angle = 2.0f * 3.14159265f * static_cast<float>(i) / static_cast<float>(kLassoPoints);
+        points.push_back({cx + rx * std::cos(angle) + wobble(rng), cy + ry * std::sin(angle) + wobble(rng)});
+    }
+    return points;
+}
+
+// What the editor did before the index: every object against every edge.
+std::vector<uint32_t> bruteLasso(const Level& level, const std::vector<SelectionPoint>& raw) {
+    // Same point thinning as SelectionPolygon::assign.
+    std::vector<SelectionPoint> kept;
+    for (const SelectionPoint& point : raw) {
+        if (!kept.empty()) {
+            float dx = point.x - kept.back().x;
+            float dy = point.y - kept.back().y;
+            if (dx * dx + dy * dy <= kLassoMinSpacing * kLassoMinSpacing) {
+                continue;
+            }
+        }
+        kept.push_back(point);
+    }
+
+    std::vector<uint32_t> inside;
+    for (uint32_t handle = 0; handle < level.bounds.size(); ++handle) {
+        const BroadPhaseRect& rect = level.bounds[handle];
+        float x = (rect.minX + rect.maxX) * 0.5f;
+        float y = (rect.minY + rect.maxY) * 0.5f;
+        bool in = false;
+        for (size_t i = 0; i < kept.size(); ++i) {
+            const SelectionPoint& from = kept[i];
+            const SelectionPoint& to = kept[(i + 1) % kept.size()];
+            float slope = to.y != from.y ? (to.x - from.x) / (to.y - from.y) : 0.0f;
+            if (y >= std::min(from.y, to.y) && y < std::max(from.y, to.y) && x < from.x + slope * (y - from.y)) {
+                in = !in;
+            }
+        }
+        if (in) {
+            inside.push_back(handle);
+        }
+    }
+    return inside;
+}
+
+std::vector<uint32_t> bruteWand(const Level& level, uint32_t seed) {
+    std::vector<uint8_t> selected(level.bounds.size(), 0);
+    std::vector<uint32_t> out{seed};
+    selected[seed] = 1;
+    for (size_t head = 0; head < out.size(); ++head) {
+        const BroadPhaseRect& rect = level.bounds[out[head]];
+        BroadPhaseRect area{rect.minX - kWandGap, rect.minY - kWandGap, rect.maxX + kWandGap, rect.maxY + kWandGap};
+        for (uint32_t handle = 0; handle < level.bounds.size(); ++handle) {
+            if (!selected[handle] && level.types[handle] == level.types[seed] &&
+                level.bounds[handle].intersects(area)) {
+                selected[handle] = 1;
+                out.push_back(handle);
+            }
+        }
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+} // namespace
+
+int main() {
+    EditorSelectionQueries queries;
+    std::vector<uint32_t> selection;
+
+    // ===== CORRECTNESS =====
+    {
+        std::mt19937 rng(4);
+        Level level = makeLevel(20000, rng);
+        EditorSpatialIndex index;
+        for (const BroadPhaseRect& rect : level.bounds) {
+            index.insert(rect);
+        }
+        auto sameType = [&](uint32_t seed, uint32_t candidate) { return level.types[candidate] == level.types[seed]; };
+
+        for (float margin : {-300.0f, 0.0f, 400.0f}) {
+            std::vector<SelectionPoint> lasso = makeLasso(level.wall, margin, rng);
+            SelectionPolygon polygon;
+            polygon.assign(lasso.data(), lasso.size(), kLassoMinSpacing);
+            queries.insidePolygon(index, polygon, selection);
+            if (selection != bruteLasso(level, lasso)) {
+                std::printf("MISMATCH: lasso with margin %.0f differs from brute force\n", margin);
+                return 1;
+            }
+        }
+        for (uint32_t seed : {0u, 1u, 2u, 3000u, 19999u}) {
+            queries.magicWand(index, seed, kWandGap, sameType, selection);
+            if (selection != bruteWand(level, seed)) {
+                std::printf("MISMATCH: magic wand from %u differs from brute force\n", seed);
+                return 1;
+            }
+        }
+        std::printf("lasso and magic wand match brute force on %zu objects\n", level.bounds.size());
+    }
+
+    // ===== TIMING =====
+    std::mt19937 rng(8);
+    Level level = makeLevel(500000, rng);
+    EditorSpatialIndex index;
+    index.reserve(level.bounds.size());
+    for (const BroadPhaseRect& rect : level.bounds) {
+        index.insert(rect);
+    }
+    auto sameType = [&](uint32_t seed, uint32_t candidate) { return level.types[candidate] == level.types[seed]; };
+
+    std::vector<SelectionPoint> lasso = makeLasso(level.wall, 200.0f, rng);
+    std::vector<double> lassoMs, wandMs;
+    size_t lassoCount = 0, wandCount = 0;
+    for (int run = 0; run < kRuns; ++run) {
+        auto start = Clock::now();
+        SelectionPolygon polygon;
+        polygon.assign(lasso.data(), lasso.size(), kLassoMinSpacing);
+        queries.insidePolygon(index, polygon, selection);
+        lassoMs.push_back(elapsedMs(start));
+        lassoCount = selection.size();
+    }
+    for (int run = 0; run < kRuns; ++run) {
+        // Seeds are wall blocks (every third object), so each flood takes
+        // the whole wall.
+        auto start = Clock::now();
+        queries.magicWand(index, static_cast<uint32_t>(run * 3), kWandGap, sameType, selection);
+        wandMs.push_back(elapsedMs(start));
+        wandCount = selection.size();
+    }
+    std::sort(lassoMs.begin(), lassoMs.end());
+    std::sort(wandMs.begin(), wandMs.end());
+
+    std::printf("%zu objects, median (worst) of %d, budget %.0f ms:\n", level.bounds.size(), kRuns, kFrameBudgetMs);
+    std::printf("  lasso, %zu points: %.2f ms (%.2f ms), %zu selected\n", lasso.size(), lassoMs[kRuns / 2],
+                lassoMs.back(), lassoCount);
+    std::printf("  magic wand:        %.2f ms (%.2f ms), %zu selected\n", wandMs[kRuns / 2], wandMs.back(),
+                wandCount);
+    if (lassoMs[kRuns / 2] > kFrameBudgetMs || wandMs[kRuns / 2] > kFrameBudgetMs) {
+        std::printf("OVER BUDGET: a selection typically takes longer than a frame\n");
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+// bench/EditorSpatialIndexBench.cpp
+//
+// EditorSpatialIndex query latency at 10k, 100k and 500k objects, against
+// the linear scan over every object that the editor queries used before.
+// Objects are 10-60 unit squares spread over a level sized to keep about
+// 100 objects per 30 units of width, so density stays the same and only
+// the level length grows. Queries are the ones the editor makes: the
+// visible area (570x320), a click (radius 10) and a brush (radius 90).
+// After a round of small moves the rect query is checked against a scan.
+//
+// From the repository root, with the game headers on the include path:
+//   g++ -std=c++17 -O2 -I. bench/EditorSpatialIndexBench.cpp EditorSpatialIndex.cpp CollisionBroadPhase.cpp
+//   ./a.out
+
+#include "../EditorSpatialIndex.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedUs(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+constexpr int kQueries = 2000;
+constexpr int kLinearQueries = 200;
+constexpr int kUpdates = 100000;
+
+} // namespace
+
+int main() {
+    for (size_t count : {size_t(10000), size_t(100000), size_t(500000)}) {
+        std::mt19937 rng(1);
+        float width = 30.0f * static_cast<float>(count / 100);
+        std::uniform_real_distribution<float> randomX(0.0f, width);
+        std::uniform_real_distribution<float> randomY(0.0f, 3000.0f);
+        std::uniform_real_distribution<float> randomSize(10.0f, 60.0f);
+
+        std::vector<BroadPhaseRect> bounds(count);
+        for (BroadPhaseRect& rect : bounds) {
+            float x = randomX(rng);
+            float y = randomY(rng);
+            float size = randomSize(rng);
+            rect = {x, y, x + size, y + size};
+        }
+
+        EditorSpatialIndex index;
+        index.reserve(count);
+        auto start = Clock::now();
+        for (const BroadPhaseRect& rect : bounds) {
+            index.insert(rect);
+        }
+        double buildMs = elapsedUs(start) / 1000.0;
+
+        std::vector<std::pair<float, float>> points(kQueries);
+        for (auto& point : points) {
+            point = {randomX(rng), randomY(rng)};
+        }
+        auto viewAt = [](const std::pair<float, float>& point) {
+            return BroadPhaseRect{point.first, point.second, point.first + 570.0f, point.second + 320.0f};
+        };
+
+        std::vector<uint32_t> hits;
+        size_t hitCount = 0;
+        start = Clock::now();
+        for (const auto& point : points) {
+            index.queryRect(viewAt(point), hits);
+            hitCount += hits.size();
+        }
+        double rectUs = elapsedUs(start) / kQueries;
+
+        start = Clock::now();
+        for (const auto& point : points) {
+            index.queryRadius(point.first, point.second, 10.0f, hits);
+            hitCount += hits.size();
+        }
+        double clickUs = elapsedUs(start) / kQueries;
+
+        start = Clock::now();
+        for (const auto& point : points) {
+            index.queryRadius(point.first, point.second, 90.0f, hits);
+            hitCount += hits.size();
+        }
+        double brushUs = elapsedUs(start) / kQueries;
+
+        // What getObjectsInRect did before the index
+        size_t linearHits = 0;
+        start = Clock::now();
+        for (int query = 0; query < kLinearQueries; ++query) {
+            BroadPhaseRect area = viewAt(points[query]);
+            for (const BroadPhaseRect& rect : bounds) {
+                linearHits += rect.intersects(area);
+            }
+        }
+        double linearUs = elapsedUs(start) / kLinearQueries;
+
+        std::uniform_int_distribution<uint32_t> randomHandle(0, static_cast<uint32_t>(count - 1));
+        std::uniform_real_distribution<float> nudge(-15.0f, 15.0f);
+        start = Clock::now();
+        for (int update = 0; update < kUpdates; ++update) {
+            uint32_t handle = randomHandle(rng);
+            BroadPhaseRect rect = index.bounds(handle);
+            float dx = nudge(rng);
+            float dy = nudge(rng);
+            index.update(handle, {rect.minX + dx, rect.minY + dy, rect.maxX + dx, rect.maxY + dy});
+        }
+        double updateNs = elapsedUs(start) * 1000.0 / kUpdates;
+
+        for (int query = 0; query < 100; ++query) {
+            BroadPhaseRect area = viewAt(points[query]);
+            index.queryRect(area, hits);
+            std::vector<uint32_t> expected;
+            for (uint32_t handle = 0; handle < count; ++handle) {
+                if (index.bounds(handle).intersects(area)) {
+                    expected.push_back(handle);
+                }
+            }
+            if (hits != expected) {
+                std::printf("MISMATCH at %zu objects, query %d\n", count, query);
+                return 1;
+            }
+        }
+
+        std::printf("%zu objects: build %.1f ms | view rect %.1f us (linear %.1f us) | "
+                    "click %.2f us | radius 90 %.2f us | move %.0f ns  [%zu/%zu hits]\n",
+                    count, buildMs, rectUs, linearUs, clickUs, brushUs, updateNs, hitCount, linearHits);
+    }
+    return 0;
+}
@@ -0,0 +1,178 @@
+// bench/EditorUndoLogBench.cpp
+//
+// Cost of mirroring EditorUndoHistory into EditorUndoLog, per recorded step,
+// as the editor thread sees it: history only, with the log (the writer
+// thread does the write()), and with a flush() after every step, which is
+// what writing from the editor thread would cost. Steps are moves of a
+// 500-object selection, with a 64 KB create (a large paste) every 50th.
+// Then the log is reopened: once for the level save it was stamped with,
+// which restores every step, and once for a different save, which starts
+// it over. Last, a level is saved both ways and reopened with the stamp
+// deserializeLevel takes from what it loads: the binary save (what
+// saveLevel writes) must bring the steps back, the same level as text must
+// start the log over, since its objects come back with new unique IDs.
+//
+// From the repository root, with the game headers on the include path:
+//   g++ -std=c++17 -O2 -I. bench/EditorUndoLogBench.cpp EditorUndoLog.cpp EditorUndoHistory.cpp MappedFile.cpp LevelBinaryFormat.cpp EditorObjectRecord.cpp -lz -lpthread
+//   ./a.out [log path]
+
+#include "../EditorUndoLog.hpp"
+#include "../LevelBinaryFormat.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedUs(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+constexpr int kSteps = 4000;
+constexpr uint64_t kSavedStamp = 0x5eed;
+
+// LevelEditorLayer::deserializeLevel's m_levelStamp for data.
+uint64_t stampOfLoad(const std::string& data) {
+    return LevelBinaryFormat::isBinary(data) ? EditorUndoLog::levelStampOf(data) : 0;
+}
+
+// Steps restored by reopening the log at path for a load of data.
+size_t reopenFor(const std::string& path, const std::string& data) {
+    EditorUndoLog log;
+    EditorUndoHistory history;
+    log.open(path, stampOfLoad(data));
+    history.attachLog(&log);
+    size_t restored = history.undoCount();
+    history.detachLog();
+    log.close();
+    return restored;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string path = argc > 1 ? argv[1] : "/tmp/EditorUndoLogBench.undo";
+
+    std::vector<int> selection;
+    for (int i = 0; i < 500; ++i) {
+        selection.push_back(10 + i * 3);
+    }
+    std::string pasted(64 * 1024, 'x');
+
+    const char* modes[] = {"history only", "log", "log + flush"};
+    for (int mode = 0; mode < 3; ++mode) {
+        ::unlink(path.c_str());
+        EditorUndoLog log;
+        EditorUndoHistory history;
+        if (mode > 0) {
+            if (!log.open(path, kSavedStamp)) {
+                std::printf("can't open %s\n", path.c_str());
+                return 1;
+            }
+            history.attachLog(&log);
+        }
+
+        std::vector<double> times;
+        times.reserve(kSteps);
+        for (int step = 0; step < kSteps; ++step) {
+            auto start = Clock::now();
+            if (step % 50 == 0) {
+                history.recordCreate({100000 + step}, pasted);
+            } else {
+                history.recordTranslate(selection, 1.0f, 0.0f);
+            }
+            if (mode == 2) {
+                log.flush();
+            }
+            times.push_back(elapsedUs(start));
+        }
+        std::sort(times.begin(), times.end());
+        std::printf("%-12s  median %.2f us | p99 %.2f us | max %.1f us\n", modes[mode],
+                    times[times.size() / 2], times[times.size() * 99 / 100], times.back());
+
+        if (mode > 0) {
+            log.appendLevel(kSavedStamp);
+            history.detachLog();
+            log.close();
+        }
+    }
+
+    // The last run left kSteps steps (minus what the byte budget dropped)
+    // and a Level record for kSavedStamp.
+    size_t expected;
+    {
+        EditorUndoLog log;
+        EditorUndoHistory history;
+        auto start = Clock::now();
+        log.open(path, kSavedStamp);
+        history.attachLog(&log);
+        double reopenUs = elapsedUs(start);
+        expected = history.undoCount();
+        std::printf("reopen: %zu steps in %.0f us\n", expected, reopenUs);
+        history.detachLog();
+        log.close();
+    }
+    if (expected == 0) {
+        std::printf("MISMATCH: nothing restored for the saved level\n");
+        return 1;
+    }
+    {
+        EditorUndoLog log;
+        EditorUndoHistory history;
+        log.open(path, kSavedStamp + 1);
+        history.attachLog(&log);
+        if (history.undoCount() != 0) {
+            std::printf("MISMATCH: %zu steps restored for another save\n", history.undoCount());
+            return 1;
+        }
+        history.detachLog();
+        log.close();
+    }
+
+    // A session on a level, ending in a save; serializeLevel stamps the log
+    // with the binary bytes.
+    std::vector<EditorObjectRecord> records(300);
+    for (size_t i = 0; i < records.size(); ++i) {
+        records[i].uniqueID = static_cast<int32_t>(1000 + i * 7);
+        records[i].objectID = 1;
+        records[i].x = 30.0f * static_cast<float>(i);
+    }
+    std::string binary, text;
+    if (!LevelBinaryFormat::write(records, true, binary, "kS38,1")) {
+        std::printf("MISMATCH: the level didn't save as binary\n");
+        return 1;
+    }
+    text = "kS38,1;";
+    appendObjectStrings(records, text);
+    ::unlink(path.c_str());
+    {
+        EditorUndoLog log;
+        EditorUndoHistory history;
+        log.open(path, 0);
+        history.attachLog(&log);
+        for (int step = 0; step < 20; ++step) {
+            history.recordTranslate({records[step].uniqueID}, 1.0f, 0.0f);
+        }
+        log.appendLevel(EditorUndoLog::levelStampOf(binary));
+        history.detachLog();
+        log.close();
+    }
+    size_t fromBinary = reopenFor(path, binary);
+    if (fromBinary != 20) {
+        std::printf("MISMATCH: %zu of 20 steps restored on reopening the binary save\n", fromBinary);
+        return 1;
+    }
+    size_t fromText = reopenFor(path, text);
+    if (fromText != 0) {
+        std::printf("MISMATCH: %zu steps restored for a text save, whose unique IDs are new\n", fromText);
+        return 1;
+    }
+    std::printf("reopen after save: binary restores %zu steps, text starts over\n", fromBinary);
+    ::unlink(path.c_str());
+    return 0;
+}
@@ -0,0 +1,151 @@
+// bench/GameObjectTeardownBench.cpp
+//
+// Cost of freeing the string and particle-array fields of 100k objects, the
+// way GameObject's destructor does it. Three layouts:
+//   raw       char*/int* fields; every string is compared against a shared
+//             empty rep (the gnustl sentinel) before delete[], as the
+//             original binary did
+//   handles   OwnedString / OwnedBuffer<int>, freed by their tag
+//   arena     the same handles, large buffers carved from one
+//             ObjectBufferArena that goes in a single release
+// Field contents are the same in all three: most objects have nothing to
+// free, some have a short particle string that fits inline, a few have
+// long ones and particle arrays.
+//
+// From the repository root, with the game headers on the include path:
+//   g++ -std=c++17 -O2 -I. bench/GameObjectTeardownBench.cpp OwnedBuffer.cpp
+//   ./a.out
+
+#include "../OwnedBuffer.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+constexpr int kObjects = 100000;
+constexpr int kRuns = 5;
+
+struct Contents {
+    std::string particle;
+    std::string text;
+    std::vector<int> colors;
+};
+
+// The layout before OwnedBuffer: the empty rep is shared and must not be
+// freed, so every field is compared against it first.
+char g_emptyRep[1] = {0};
+
+struct RawObject {
+    char* particle = g_emptyRep;
+    char* text = g_emptyRep;
+    int*  colors = nullptr;
+
+    ~RawObject() {
+        if (particle != g_emptyRep) delete[] particle;
+        if (text != g_emptyRep) delete[] text;
+        delete[] colors;
+    }
+};
+
+char* rawCopy(const std::string& source) {
+    if (source.empty()) {
+        return g_emptyRep;
+    }
+    char* copy = new char[source.size() + 1];
+    std::memcpy(copy, source.c_str(), source.size() + 1);
+    return copy;
+}
+
+struct HandleObject {
+    OwnedString particle;
+    OwnedString text;
+    OwnedBuffer<int> colors;
+};
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(11);
+    std::vector<Contents> contents(kObjects);
+    for (Contents& c : contents) {
+        int kind = static_cast<int>(rng() % 100);
+        if (kind < 20) {
+            c.particle = "30a-1a1a0.3a30";
+        } else if (kind < 25) {
+            c.particle = "30a-1a1a0.3a30a90a90a29a0a11a0a0a0a0a0a0a0a2a1a0a0.1a0a0a0a0a0a0a0a0";
+            c.colors.assign(4 + rng() % 12, 255);
+        }
+        if (kind >= 98) {
+            c.text = "Welcome to the level, this is a text object";
+        }
+    }
+
+    double rawMs = 0.0, handleMs = 0.0, arenaMs = 0.0;
+    for (int run = 0; run < kRuns; ++run) {
+        {
+            std::vector<RawObject>* objects = new std::vector<RawObject>(kObjects);
+            for (int i = 0; i < kObjects; ++i) {
+                RawObject& o = (*objects)[i];
+                o.particle = rawCopy(contents[i].particle);
+                o.text = rawCopy(contents[i].text);
+                if (!contents[i].colors.empty()) {
+                    o.colors = new int[contents[i].colors.size()];
+                    std::memcpy(o.colors, contents[i].colors.data(), contents[i].colors.size() * sizeof(int));
+                }
+            }
+            auto start = Clock::now();
+            delete objects;
+            rawMs += elapsedMs(start);
+        }
+        {
+            std::vector<HandleObject>* objects = new std::vector<HandleObject>(kObjects);
+            for (int i = 0; i < kObjects; ++i) {
+                HandleObject& o = (*objects)[i];
+                o.particle.assign(contents[i].particle.c_str(), contents[i].particle.size());
+                o.text.assign(contents[i].text.c_str(), contents[i].text.size());
+                o.colors.assign(contents[i].colors.data(), contents[i].colors.size());
+            }
+            auto start = Clock::now();
+            delete objects;
+            handleMs += elapsedMs(start);
+        }
+        {
+            ObjectBufferArena* arena = ObjectBufferArena::create();
+            std::vector<HandleObject>* objects = new std::vector<HandleObject>(kObjects);
+            for (int i = 0; i < kObjects; ++i) {
+                HandleObject& o = (*objects)[i];
+                o.particle.assign(contents[i].particle.c_str(), contents[i].particle.size(), *arena);
+                o.text.assign(contents[i].text.c_str(), contents[i].text.size());
+                int* colors = o.colors.allocate(contents[i].colors.size(), *arena);
+                if (colors) {
+                    std::memcpy(colors, contents[i].colors.data(), contents[i].colors.size() * sizeof(int));
+                }
+            }
+            if (run == 0) {
+                for (int i = 0; i < kObjects; ++i) {
+                    const HandleObject& o = (*objects)[i];
+                    if (contents[i].particle != o.particle.c_str() || o.colors.size() != contents[i].colors.size()) {
+                        std::printf("MISMATCH: object %d doesn't read back\n", i);
+                        return 1;
+                    }
+                }
+            }
+            auto start = Clock::now();
+            delete objects;
+            arena->release();
+            arenaMs += elapsedMs(start);
+        }
+    }
+
+    std::printf("teardown of %d objects: raw %.2f ms | handles %.2f ms | handles + arena %.2f ms\n", kObjects,
+                rawMs / kRuns, handleMs / kRuns, arenaMs / kRuns);
+    return 0;
+}
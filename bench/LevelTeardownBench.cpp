@@ -0,0 +1,184 @@
+// bench/LevelTeardownBench.cpp
+//
+// Level exit on a 100k-object level, three ways:
+//   heap         objects released in array order, each ~GameObject
+//                releasing its sprites, reading the empty-rep sentinel and
+//                freeing its particle string from the heap
+//   field passes sprites released one field at a time across all objects,
+//                physics objects freed with a single sentinel read, then
+//                the objects; particle strings from one ObjectBufferArena
+//   arena        array order as in heap, particle strings from the arena
+//                (what GameObject::destroyObjects does)
+// Stand-ins replace the cocos2d types; sprites are refcounted heap objects
+// the size of a CCSprite, allocated with their object as at level load.
+// 1% of the objects are still retained elsewhere (a trigger's target list)
+// and must come out intact.
+//
+// From the repository root, with the game headers on the include path:
+//   g++ -std=c++17 -O2 -I. bench/LevelTeardownBench.cpp OwnedBuffer.cpp
+//   ./a.out
+
+#include "../OwnedBuffer.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+constexpr int kObjects = 100000;
+constexpr int kRuns = 5;
+
+struct Sprite {
+    unsigned int references = 1;
+    char state[400];  // about a CCSprite's size
+    void release() {
+        if (--references == 0) delete this;
+    }
+};
+
+// Stands in for the empty rep behind CCDirector + 0xfe8; volatile so every
+// read the destructor does is a real load, as it was in the binary.
+char g_emptyPhysics[0x18 + 8];
+volatile uintptr_t g_sentinel = uintptr_t(g_emptyPhysics);
+
+struct Object {
+    unsigned int references = 1;
+    Sprite* mainSprite = nullptr;
+    Sprite* colorSprite = nullptr;
+    Sprite* secondarySprite = nullptr;
+    void* physicsObject = nullptr;
+    OwnedString particleString;
+    ObjectBufferArena* arena = nullptr;
+
+    virtual ~Object() {
+        if (mainSprite) mainSprite->release();
+        if (colorSprite) colorSprite->release();
+        if (secondarySprite) secondarySprite->release();
+        if (arena) arena->release();
+        if (physicsObject && uintptr_t(physicsObject) - 0x18 != g_sentinel) {
+            delete[] reinterpret_cast<char*>(uintptr_t(physicsObject) - 0x18);
+        }
+    }
+    void release() {
+        if (--references == 0) delete this;
+    }
+};
+
+const char* kParticle = "30a-1a1a0.3a30a90a90a29a0a11a0a0a0a0a0a0a0a2a1a0a0.1a0a0a0a0a0a0a0a0";
+
+std::vector<Object*> buildLevel(ObjectBufferArena* arena, std::mt19937& rng) {
+    std::vector<Object*> objects;
+    objects.reserve(kObjects);
+    for (int i = 0; i < kObjects; ++i) {
+        Object* obj = new Object();
+        obj->mainSprite = new Sprite();
+        if (rng() % 3 == 0) obj->colorSprite = new Sprite();
+        if (rng() % 10 == 0) obj->secondarySprite = new Sprite();
+        obj->physicsObject = rng() % 4 == 0 ? static_cast<void*>(new char[0x40] + 0x18)
+                                            : static_cast<void*>(g_emptyPhysics + 0x18);
+        if (rng() % 5 == 0) {
+            if (arena) {
+                arena->retain();
+                obj->arena = arena;
+                obj->particleString.assign(kParticle, std::strlen(kParticle), *arena);
+            } else {
+                obj->particleString.assign(kParticle);
+            }
+        }
+        objects.push_back(obj);
+    }
+    return objects;
+}
+
+// The field-at-a-time order destroyObjects used before.
+void destroyByFieldPasses(std::vector<Object*>& objects, const std::vector<bool>& retainedElsewhere) {
+    std::vector<Object*> dying;
+    dying.reserve(objects.size());
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (!retainedElsewhere[i]) dying.push_back(objects[i]);
+    }
+    for (Object* obj : dying) {
+        if (obj->mainSprite) { obj->mainSprite->release(); obj->mainSprite = nullptr; }
+    }
+    for (Object* obj : dying) {
+        if (obj->colorSprite) { obj->colorSprite->release(); obj->colorSprite = nullptr; }
+    }
+    for (Object* obj : dying) {
+        if (obj->secondarySprite) { obj->secondarySprite->release(); obj->secondarySprite = nullptr; }
+    }
+    uintptr_t sentinel = g_sentinel;
+    for (Object* obj : dying) {
+        if (obj->physicsObject && uintptr_t(obj->physicsObject) - 0x18 != sentinel) {
+            delete[] reinterpret_cast<char*>(uintptr_t(obj->physicsObject) - 0x18);
+        }
+        obj->physicsObject = nullptr;
+    }
+    for (Object* obj : objects) {
+        obj->release();
+    }
+}
+
+} // namespace
+
+int main() {
+    enum Mode { kHeap, kFieldPasses, kArena };
+    const char* names[] = {"heap", "field passes", "arena"};
+    double totalMs[3] = {};
+
+    std::mt19937 rng(5);
+    for (int run = 0; run < kRuns; ++run) {
+        std::vector<bool> retainedElsewhere(kObjects);
+        for (int i = 0; i < kObjects; ++i) {
+            retainedElsewhere[i] = rng() % 100 == 0;
+        }
+
+        for (int mode = kHeap; mode <= kArena; ++mode) {
+            ObjectBufferArena* arena = mode == kHeap ? nullptr : ObjectBufferArena::create();
+            std::vector<Object*> objects = buildLevel(arena, rng);
+            std::vector<Object*> survivors;
+            for (int i = 0; i < kObjects; ++i) {
+                if (retainedElsewhere[i]) {
+                    ++objects[i]->references;
+                    survivors.push_back(objects[i]);
+                }
+            }
+
+            auto start = Clock::now();
+            if (mode == kFieldPasses) {
+                destroyByFieldPasses(objects, retainedElsewhere);
+            } else {
+                for (Object* obj : objects) {
+                    obj->release();
+                }
+            }
+            objects.clear();
+            if (arena) {
+                arena->release();
+            }
+            totalMs[mode] += elapsedMs(start);
+
+            // The survivors keep their sprites and their arena reference.
+            for (Object* obj : survivors) {
+                if (!obj->mainSprite || std::strlen(obj->particleString.c_str()) != obj->particleString.size()) {
+                    std::printf("MISMATCH: an object retained elsewhere was torn down (%s)\n", names[mode]);
+                    return 1;
+                }
+                obj->release();
+            }
+        }
+    }
+
+    std::printf("level exit, %d objects:", kObjects);
+    for (int mode = kHeap; mode <= kArena; ++mode) {
+        std::printf("%s %s %.2f ms", mode ? " |" : "", names[mode], totalMs[mode] / kRuns);
+    }
+    std::printf("\n");
+    return 0;
+}
@@ -0,0 +1,181 @@
+// bench/LocalLevelIndexBench.cpp
+//
+// getLocalLevel on 10k and 100k local levels: importing the levels one at
+// a time (each ID looked up first, a miss, then addLocalLevel), then a
+// million hits and a million misses. The scan every lookup did before the
+// index, and every miss still did until misses were answered by it, is
+// timed on the same array for comparison; over a whole import that scan is
+// O(n^2), so it is timed on a sample of misses and scaled.
+//
+// Answers are checked against a scan of a mirror of the array through
+// adds, removes, duplicate IDs and renumbering in place (with
+// invalidateLocalLevelIndex, and without it for IDs renumbered away).
+//
+// GameLevelManager is declared in its .cpp, so it is compiled in here.
+// From the repository root, with the game headers on the include path:
+//   g++ -std=c++17 -O2 -I. bench/LocalLevelIndexBench.cpp UserNameCache.cpp LocalLevelCatalog.cpp MappedFile.cpp -pthread
+//   ./a.out
+
+#include "../GameLevelManager.cpp"
+
+#include <chrono>
+#include <random>
+
+// Standalone program: saved levels aren't used by this bench.
+LocalLevelManager* LocalLevelManager::sharedState() { return nullptr; }
+cocos2d::CCDictionary* LocalLevelManager::getAllLevelsInDict() { return nullptr; }
+cocos2d::CCFileUtils* cocos2d::CCFileUtils::sharedFileUtils() { return nullptr; }
+std::string cocos2d::CCFileUtils::getWritablePath() { return std::string(); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+constexpr int kLookups = 1000000;
+constexpr int kScanSample = 200;
+
+// What getLocalLevel did per call before the index.
+GJGameLevel* scanForID(const std::vector<GJGameLevel*>& levels, int id) {
+    for (GJGameLevel* level : levels) {
+        if (level->m_levelID == id) {
+            return level;
+        }
+    }
+    return nullptr;
+}
+
+GJGameLevel* makeLevel(int id) {
+    auto* level = new GJGameLevel();
+    level->m_levelID = id;
+    level->m_levelName = "Level " + std::to_string(id);
+    return level;
+}
+
+bool checkAgainstScan(std::mt19937& rng) {
+    GameLevelManager manager;
+    std::vector<GJGameLevel*> mirror;
+    for (int step = 0; step < 20000; ++step) {
+        int id = static_cast<int>(rng() % 3000);
+        switch (rng() % 8) {
+        case 0:
+        case 1: {
+            GJGameLevel* level = makeLevel(id);  // IDs repeat: first one wins
+            manager.addLocalLevel(level);
+            mirror.push_back(level);
+            break;
+        }
+        case 2:
+            if (!mirror.empty()) {
+                size_t at = rng() % mirror.size();
+                GJGameLevel* level = mirror[at];
+                manager.removeLocalLevel(level);
+                mirror.erase(mirror.begin() + static_cast<std::ptrdiff_t>(at));
+                delete level;
+            }
+            break;
+        case 3:
+            if (!mirror.empty()) {
+                // Renumbered in place, the way an upload gives a level its ID
+                GJGameLevel* level = mirror[rng() % mirror.size()];
+                level->m_levelID = static_cast<int>(rng() % 3000);
+                manager.invalidateLocalLevelIndex();
+            }
+            break;
+        default:
+            if (manager.getLocalLevel(id) != scanForID(mirror, id)) {
+                std::printf("MISMATCH: getLocalLevel(%d) differs from a scan at step %d\n", id, step);
+                return false;
+            }
+            break;
+        }
+    }
+
+    // Renumbered away without telling the manager: the stale hit is caught.
+    if (!mirror.empty()) {
+        GJGameLevel* level = mirror.front();
+        int oldID = level->m_levelID;
+        level->m_levelID = 100000;
+        if (manager.getLocalLevel(oldID) != scanForID(mirror, oldID)) {
+            std::printf("MISMATCH: a level renumbered away is still found by its old ID\n");
+            return false;
+        }
+    }
+    for (GJGameLevel* level : mirror) {
+        delete level;
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(13);
+    for (int round = 0; round < 5; ++round) {
+        if (!checkAgainstScan(rng)) {
+            return 1;
+        }
+    }
+    std::printf("indexed answers match a scan through adds, removes and renumbering\n");
+
+    for (int count : {10000, 100000}) {
+        std::vector<GJGameLevel*> levels;
+        levels.reserve(static_cast<size_t>(count));
+        for (int i = 0; i < count; ++i) {
+            levels.push_back(makeLevel(1000 + i * 2));  // odd IDs are never used
+        }
+        auto* manager = new GameLevelManager();
+
+        auto start = Clock::now();
+        for (GJGameLevel* level : levels) {
+            if (manager->getLocalLevel(level->m_levelID)) {
+                std::printf("MISMATCH: level %d found before it was added\n", level->m_levelID);
+                return 1;
+            }
+            manager->addLocalLevel(level);
+        }
+        double importMs = elapsedMs(start);
+
+        // The scan's cost per miss grows with the array, so an import pays
+        // about half a full-array scan per level on average.
+        start = Clock::now();
+        size_t found = 0;
+        for (int i = 0; i < kScanSample; ++i) {
+            found += scanForID(levels, 1001 + 2 * static_cast<int>(rng() % count)) != nullptr;
+        }
+        double scanMissMs = elapsedMs(start) / kScanSample;
+        double scanImportMs = scanMissMs * count / 2.0;
+
+        std::vector<int> ids(kLookups);
+        for (int& id : ids) {
+            id = 1000 + 2 * static_cast<int>(rng() % count);
+        }
+        start = Clock::now();
+        for (int id : ids) {
+            found += manager->getLocalLevel(id) != nullptr;
+        }
+        double hitMs = elapsedMs(start);
+        start = Clock::now();
+        for (int id : ids) {
+            found += manager->getLocalLevel(id + 1) != nullptr;
+        }
+        double missMs = elapsedMs(start);
+        if (found != static_cast<size_t>(kLookups)) {
+            std::printf("MISMATCH: %zu of %d lookups found a level\n", found, kLookups);
+            return 1;
+        }
+
+        std::printf("%6d levels: import %.1f ms (scan on miss: ~%.0f ms) | hit %.0f ns | miss %.0f ns "
+                    "(scan: %.0f ns)\n",
+                    count, importMs, scanImportMs, hitMs * 1e6 / kLookups, missMs * 1e6 / kLookups,
+                    scanMissMs * 1e6);
+        delete manager;
+        for (GJGameLevel* level : levels) {
+            delete level;
+        }
+    }
+    return 0;
+}
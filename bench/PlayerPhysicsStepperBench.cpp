@@ -0,0 +1,162 @@
+// bench/PlayerPhysicsStepperBench.cpp
+//
+// Throughput of PlayerPhysicsStepper: headless substeps per second
+// (stepTicks, what HeadlessLevelSimulator and replay verification run), and
+// the cost of one rendered frame of advance() at 60, 144 and 240 fps with a
+// tap queued every few frames. A jump lands every 100 substeps and gravity flips
+// every 5000, so every branch of integrate() is taken.
+//
+// Substeps and interpolated frames are checked against reference code
+// written here with every product rounded through a volatile, i.e. with no
+// FMA. integrate() only multiplies by powers of two and +-1, which are exact
+// either way; interpolatedState() blends by the accumulator fraction, which
+// is where a contracted a*b+c shows up (built with -march=native on a
+// machine with FMA, without the pragma in PlayerPhysicsStepper.cpp, the
+// interpolation check fails within the first few frames). The final state hash is printed so runs on
+// different devices and compilers can be compared.
+//
+// From the repository root, with the game headers on the include path:
+//   g++ -std=c++17 -O2 -march=native -I. bench/PlayerPhysicsStepperBench.cpp PlayerPhysicsStepper.cpp InputLatency.cpp
+//   ./a.out
+
+#include "../PlayerPhysicsStepper.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+constexpr uint32_t kTicks = 10000000;
+constexpr float kJumpVelocity = PlayerPhysicsStepper::kJumpVelocity;
+
+float rounded(float value) {
+    volatile float stored = value;
+    return stored;
+}
+
+// PlayerPhysicsStepper::integrate with each product rounded on its own.
+void referenceIntegrate(PlayerPhysicsState& s) {
+    const float scale = PlayerPhysicsStepper::kSubstepScale;
+    if (!s.onGround) {
+        float gravityStep = rounded(s.gravity * scale);
+        s.yVelocity -= rounded(gravityStep * static_cast<float>(s.gravityDir));
+        float fall = rounded(s.yVelocity * static_cast<float>(s.gravityDir));
+        if (fall < -s.terminalVelocity) {
+            s.yVelocity = rounded(-s.terminalVelocity * static_cast<float>(s.gravityDir));
+        }
+    }
+    s.x += rounded(s.xVelocity * scale);
+    s.y += rounded(s.yVelocity * scale);
+    if (s.gravityDir == 1 && s.y <= s.floorY && s.yVelocity <= 0.0f) {
+        s.y = s.floorY;
+        s.yVelocity = 0.0f;
+        s.onGround = true;
+    } else if (s.gravityDir == -1 && s.y >= s.ceilingY && s.yVelocity >= 0.0f) {
+        s.y = s.ceilingY;
+        s.yVelocity = 0.0f;
+        s.onGround = true;
+    }
+}
+
+PlayerPhysicsState startState() {
+    PlayerPhysicsState state;
+    state.xVelocity = 5.770002f;  // 1x speed
+    state.ceilingY = 405.0f;
+    return state;
+}
+
+} // namespace
+
+int main() {
+    // ===== HEADLESS =====
+    PlayerPhysicsStepper stepper(startState());
+    auto start = Clock::now();
+    for (uint32_t tick = 0; tick < kTicks; tick += 100) {
+        if (tick % 5000 == 0) {
+            stepper.flipGravity();
+        }
+        stepper.setYVelocity(kJumpVelocity * static_cast<float>(-stepper.state().gravityDir));
+        stepper.stepTicks(100);
+    }
+    double headlessMs = elapsedMs(start);
+    std::printf("headless: %u substeps in %.1f ms (%.1f M substeps/s, %.0f x realtime) | final hash %016llx\n",
+                kTicks, headlessMs, kTicks / 1e3 / headlessMs,
+                kTicks / static_cast<double>(PlayerPhysicsStepper::kSubstepsPerSecond) / (headlessMs / 1e3),
+                static_cast<unsigned long long>(hashPlayerState(stepper.state())));
+
+    PlayerPhysicsState reference = startState();
+    PlayerPhysicsStepper check(startState());
+    for (uint32_t tick = 0; tick < 200000; ++tick) {
+        if (tick % 100 == 0) {
+            if (tick % 5000 == 0) {
+                check.flipGravity();
+                reference.gravityDir = -reference.gravityDir;
+                reference.onGround = false;
+            }
+            float velocity = kJumpVelocity * static_cast<float>(-reference.gravityDir);
+            check.setYVelocity(velocity);
+            reference.yVelocity = velocity;
+            reference.onGround = false;
+        }
+        check.step();
+        referenceIntegrate(reference);
+        if (hashPlayerState(check.state()) != hashPlayerState(reference)) {
+            std::printf("MISMATCH: the stepper left the unfused reference at substep %u "
+                        "(y %.9g vs %.9g); is a*b+c being contracted?\n",
+                        tick + 1, check.state().y, reference.y);
+            return 1;
+        }
+    }
+    std::printf("200000 substeps bit-identical to the unfused reference\n");
+
+    // ===== RENDERED =====
+    for (int fps : {60, 144, 240}) {
+        PlayerPhysicsStepper rendered(startState());
+        int taps = 0;
+        rendered.setInputHandler([](void* context, const TimedInput&) { ++*static_cast<int*>(context); }, &taps);
+        const float frameDelta = 1.0f / static_cast<float>(fps);
+        const uint64_t frameNs = 1000000000ull / static_cast<uint64_t>(fps);
+        const int frames = fps * 600;  // ten minutes of play
+
+        uint64_t now = 1000000000ull;
+        start = Clock::now();
+        for (int frame = 0; frame < frames; ++frame) {
+            now += frameNs;
+            if (frame % 7 == 0) {
+                rendered.queueInput({now - frameNs / 2, 1, frame % 14 == 0});
+            }
+            rendered.advance(frameDelta, now);
+        }
+        double renderedMs = elapsedMs(start);
+        std::printf("advance() at %3d fps: %.1f ns per frame (%d frames, %u substeps, %d inputs delivered)\n", fps,
+                    renderedMs * 1e6 / frames, frames, rendered.tick(), taps);
+    }
+
+    // Interpolation, one frame at a time, against the unfused blend.
+    PlayerPhysicsStepper rendered(startState());
+    for (int frame = 0; frame < 144 * 60; ++frame) {
+        if (frame % 50 == 0) {
+            rendered.setYVelocity(kJumpVelocity);
+        }
+        rendered.advance(1.0f / 144.0f);
+        float alpha = rendered.interpolationAlpha();
+        float inverse = 1.0f - alpha;
+        float x = rounded(rendered.previousState().x * inverse) + rounded(rendered.state().x * alpha);
+        float y = rounded(rendered.previousState().y * inverse) + rounded(rendered.state().y * alpha);
+        PlayerPhysicsState blended = rendered.interpolatedState();
+        if (blended.x != x || blended.y != y) {
+            std::printf("MISMATCH: interpolatedState() left the unfused blend at frame %d "
+                        "(y %.9g vs %.9g); is a*b+c being contracted?\n",
+                        frame, blended.y, y);
+            return 1;
+        }
+    }
+    std::printf("%d interpolated frames bit-identical to the unfused blend\n", 144 * 60);
+    return 0;
+}
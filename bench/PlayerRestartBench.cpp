@@ -0,0 +1,146 @@
+// bench/PlayerRestartBench.cpp
+//
+// Level restart on a 50k-object level, the two ways resetPlayers has:
+//   rebuild   both players destroyed and created again, then
+//             setupPlayerForLevel (collision log sized to the level, slope
+//             solver set, no current slope), as after a mode change
+//   reset     PlayerObject::reset on the existing players: stepper back to
+//             the start state, log cleared, slope chain dropped
+// Stand-ins replace the cocos2d parts of a player; its sprites, streak and
+// emitters are heap blocks the size of theirs, allocated as createPlayer
+// does.
+//
+// After either path each player must look like one set up fresh for the
+// level: same stepper state, a log that drops a repeated contact (an
+// unsized log can't, which is what the rebuild path used to leave), the
+// level's solver and slope -1.
+//
+// From the repository root, with the game headers on the include path:
+//   g++ -std=c++17 -O2 -I. bench/PlayerRestartBench.cpp PlayerPhysicsStepper.cpp PlayerCollisionLog.cpp SlopeSolver.cpp InputLatency.cpp
+//   ./a.out
+
+#include "../PlayerCollisionLog.hpp"
+#include "../PlayerPhysicsStepper.hpp"
+#include "../SlopeSolver.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+constexpr size_t kObjects = 50000;
+constexpr int kRestarts = 2000;
+
+struct Node {
+    char state[600];  // about a CCSprite / CCParticleSystemQuad
+};
+
+// The parts of PlayerObject a restart touches.
+struct Player {
+    std::vector<std::unique_ptr<Node>> nodes;
+    PlayerPhysicsStepper stepper;
+    PlayerCollisionLog collisionLog;
+    const SlopeSolver* slopeSolver = nullptr;
+    int32_t currentSlope = -1;
+
+    Player() {
+        // Icon, ship, glow, detail and wave sprites, streak, emitters
+        for (int i = 0; i < 16; ++i) {
+            nodes.emplace_back(new Node());
+        }
+        stepper.reset(startState());
+    }
+
+    static PlayerPhysicsState startState() {
+        PlayerPhysicsState state;
+        state.xVelocity = 5.770002f;
+        state.ceilingY = 405.0f;
+        return state;
+    }
+
+    void reset() {
+        stepper.reset(startState());
+        currentSlope = -1;
+        collisionLog.clear();
+    }
+};
+
+// GJBaseGameLayer::setupPlayerForLevel
+void setupPlayerForLevel(Player* player, const SlopeSolver& solver) {
+    player->collisionLog.resize(kObjects);
+    player->slopeSolver = &solver;
+    player->currentSlope = -1;
+}
+
+// A few ticks of play, so the restart has something to undo.
+void play(Player& player) {
+    player.stepper.setJumpHeld(true);
+    player.stepper.stepTicks(300);
+    player.currentSlope = 3;
+    player.collisionLog.add({42, 0.0f, 0.0f, CollisionContactKind::Solid, true});
+}
+
+bool setUpForLevel(Player& player, const SlopeSolver& solver) {
+    PlayerCollisionLog& log = player.collisionLog;
+    log.clear();
+    CollisionContact contact = {kObjects - 1, 0.0f, 0.0f, CollisionContactKind::Touch, false};
+    bool dedupes = log.add(contact) && !log.add(contact);
+    log.clear();
+    return dedupes && player.slopeSolver == &solver && player.currentSlope == -1 &&
+           hashPlayerState(player.stepper.state()) == hashPlayerState(Player::startState());
+}
+
+} // namespace
+
+int main() {
+    SlopeSolver solver;
+    for (uint32_t i = 0; i < 200; ++i) {
+        solver.addSlope(i * 250, static_cast<float>(i) * 300.0f, 0.0f, 30.0f, 30.0f, false, false);
+    }
+    solver.link();
+
+    std::unique_ptr<Player> players[2] = {std::make_unique<Player>(), std::make_unique<Player>()};
+    for (auto& player : players) {
+        setupPlayerForLevel(player.get(), solver);
+    }
+
+    double rebuildMs = 0.0, resetMs = 0.0;
+    for (int restart = 0; restart < kRestarts; ++restart) {
+        bool rebuild = restart % 2 == 0;
+        for (auto& player : players) {
+            play(*player);
+        }
+
+        auto start = Clock::now();
+        if (rebuild) {
+            for (auto& player : players) {
+                player.reset(new Player());
+                setupPlayerForLevel(player.get(), solver);
+            }
+            rebuildMs += elapsedMs(start);
+        } else {
+            for (auto& player : players) {
+                player->reset();
+            }
+            resetMs += elapsedMs(start);
+        }
+
+        for (auto& player : players) {
+            if (!setUpForLevel(*player, solver)) {
+                std::printf("MISMATCH: a player after %s isn't set up for the level\n", rebuild ? "rebuild" : "reset");
+                return 1;
+            }
+        }
+    }
+
+    std::printf("restart, 2 players, %zu objects: rebuild %.3f ms | reset %.3f ms\n", kObjects,
+                rebuildMs / (kRestarts / 2), resetMs / (kRestarts / 2));
+    return 0;
+}
@@ -15,11 +15,34 @@
 #include <vector>
 
 // Project source index:
+// - CollisionBroadPhase.cpp / .hpp: section-grid broad-phase for player collisions.
 // - GJBaseGameLayer.cpp / .hpp: core layer logic (player creation, effects).
 // - GJEffectManager.cpp / .hpp: effect manager destructor and containers.
-// - GameObject.cpp / .hpp: GameObject destructor and cleanup.
+// - GameObject.cpp / .hpp: GameObject destructor, cleanup and bulk teardown.
 // - GameLevelManager.cpp / .hpp: local level lookups and username caching.
+// - OwnedBuffer.cpp / .hpp: ownership-tagged string/buffer handles.
+// - HeadlessLevelSimulator.cpp / .hpp: cocos-free batch level validation runner.
+// - MappedFile.cpp / .hpp: read-only mmap wrapper.
+// - LocalLevelCatalog.cpp / .hpp: memory-mapped ID/name index of saved levels with lazy level data.
+// - UserNameCache.cpp / .hpp: bounded LRU userID -> name/accountID cache for GameLevelManager.
+// - PlayerIconCache.cpp / .hpp: refcounted icon sheets and player colors, background preload.
+// - PlayerUpdateWorker.cpp / .hpp: background thread for dual mode player 2 updates.
+// - InputLatency.cpp / .hpp: input capture timestamps and latency percentiles.
+// - EditorSpatialIndex.cpp / .hpp: dynamic hashed grid behind editor hit tests and rect/radius queries.
+// - EditorSelectionQueries.cpp / .hpp: lasso/polygon hit tests and magic-wand flood over the spatial index.
+// - EditorUndoHistory.cpp / .hpp: command-based editor undo/redo with ID-run encoding and a byte budget.
+// - EditorUndoLog.cpp / .hpp: append-only on-disk undo log, lazily restored from a mapping, background writer.
+// - EditorObjectRecord.cpp / .hpp: plain per-object save record, GD object string writer and parser.
+// - EditorAutoSave.cpp / .hpp: dirty-tracked incremental autosave with per-chunk compression cache.
+// - LevelBinaryFormat.cpp / .hpp: versioned columnar binary level data, delta-coded, optional zlib.
+// - ByteStream.hpp: varint/zigzag byte writer and bounds-checked reader for binary formats.
 // - LevelEditorLayer.cpp / .hpp: editor layer interface outline.
 // - PlayerObject.cpp / .hpp: PlayerObject destructor and cleanup.
+// - PlayerCollisionLog.cpp / .hpp: fixed-capacity, allocation-free per-tick contact log.
+// - PlayerParticleManager.cpp / .hpp: pooled, batched player particle emitters.
+// - PlayerPhysicsStepper.cpp / .hpp: fixed-timestep (240 Hz) player physics.
+// - PlayerReplay.cpp / .hpp: input replay recording/playback and tick checksums.
+// - SlopeSolver.cpp / .hpp: precomputed slope lines and slope chains.
 // - SimplePlayer.cpp / .hpp: SimplePlayer destructor and cleanup.
 // - getGameObjectPhysics.cpp / .hpp: physics table lookup/insert logic.
+// - bench/*.cpp: standalone benchmark/check programs (build line at the top of each).